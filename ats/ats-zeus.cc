@@ -9,7 +9,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <dlfcn.h>
-#include <sstream>
+#include <memory>
 #include <string>
 #include <ts/apidefs.h>
 #include <ts/remap.h>
@@ -17,7 +17,9 @@
 #include <unistd.h>
 #include <vector>
 
+#include "cache.h"
 #include "common.h"
+#include "epoch.h"
 #include "library.h"
 
 #ifndef PLUGIN_TAG
@@ -27,9 +29,23 @@
 static const char * const VERSION = "version";
 static const char * const KEYS = "keys";
 
+static const char NOT_FOUND[] = "HTTP/1.1 404 NOT FOUND" "\r\n"
+  "Content-Type: text/html; charset=UTF-8" "\r\n"
+  "Content-Length: 18" "\r\n"
+  "\r\n"
+  "<h2>NOT FOUND</h2>";
+
+//room for the longest response header
+static const int HEADER = 192;
+
 static int maxAge = 0;
 
+//bytes, per library instance
+static size_t cacheSize = 8 * 1024 * 1024;
+
 static struct {
+  int cacheHits;
+  int cacheMisses;
   int hits;
   int notFounds;
   int size; //average
@@ -38,6 +54,12 @@ static struct {
 } statistics;
 
 void initializeStatistics(void) {
+  statistics.cacheHits = TSStatCreate(PLUGIN_TAG "_service" ".cacheHits", TS_RECORDDATATYPE_INT,
+      TS_STAT_NON_PERSISTENT, TS_STAT_SYNC_COUNT);
+
+  statistics.cacheMisses = TSStatCreate(PLUGIN_TAG "_service" ".cacheMisses", TS_RECORDDATATYPE_INT,
+      TS_STAT_NON_PERSISTENT, TS_STAT_SYNC_COUNT);
+
   statistics.hits = TSStatCreate(PLUGIN_TAG "_service" ".hits", TS_RECORDDATATYPE_INT,
       TS_STAT_NON_PERSISTENT, TS_STAT_SYNC_COUNT);
 
@@ -82,6 +104,22 @@ TSReturnCode TSRemapInit(TSRemapInterface *, char *, int) {
     }
   }
 
+  {
+    const char * const cacheSizeEnv = getenv(PLUGIN_TAG "__cache_size");
+
+    if (cacheSizeEnv != NULL) {
+      const long size = atol(cacheSizeEnv);
+      if (size < 0) {
+        TSError("[" PLUGIN_TAG "] response cache size is negative: %li."
+            " Resetting to 0 (disabled).", size);
+        cacheSize = 0;
+      } else {
+        cacheSize = size;
+        TSDebug(PLUGIN_TAG, "response cache size set to %li bytes.", size);
+      }
+    }
+  }
+
   initializeStatistics();
 
   return TS_SUCCESS;
@@ -105,7 +143,21 @@ TSReturnCode TSRemapNewInstance(int c, char * * v, void * * i, char *, int) {
   TSDebug(PLUGIN_TAG, "new instance");
   assert(c >= 3);
   TSDebug(PLUGIN_TAG, "config library: %s", v[2]);
-  Library * const library = new Library(v[2], 5);
+
+  //how many versions stay loaded, the optional second parameter
+  int depth = 5;
+
+  if (c >= 4) {
+    depth = atoi(v[3]);
+    if (depth < 1 || depth > 100) {
+      TSError("[" PLUGIN_TAG "] number of versions is out of range (1..100): %i."
+          " Resetting to 5.", depth);
+      depth = 5;
+    }
+  }
+
+  TSDebug(PLUGIN_TAG, "keeping %d versions loaded.", depth);
+  Library * const library = new Library(v[2], depth, cacheSize);
   assert(library != NULL);
   *i = library;
   const TSCont continuation = TSContCreate(ServerUpdate, NULL);
@@ -122,25 +174,30 @@ void TSRemapDeleteInstance(void * i) {
 }
 
 struct Data {
-  char * data;
-  int size;
-  std::string context;
-  std::string version;
-  int cache;
+  TSIOBuffer buffer;
+  TSIOBufferReader reader;
+  int size; //response body, 0 if not found
   struct timespec start;
 
   ~Data() {
-    if (data != NULL) {
-      assert(size > 0);
-      free(data);
-    }
+    assert(buffer != NULL);
+    TSIOBufferDestroy(buffer);
   }
 
-  Data(void) : data(NULL), size(0), cache(0) {
+  Data(void) : buffer(TSIOBufferCreate()), reader(NULL), size(0) {
+    assert(buffer != NULL);
+    reader = TSIOBufferReaderAlloc(buffer);
+    assert(reader != NULL);
     clock_gettime(CLOCK_MONOTONIC, &start);
   }
 };
 
+//copies n bytes of s to c, returns the position right after them
+char * copy(char * const c, const char * const s, const size_t n) {
+  memcpy(c, s, n);
+  return c + n;
+}
+
 int ServerIntercept(TSCont c, TSEvent e, void * d) {
   assert(c != NULL);
   Data * const data = static_cast< Data * >(TSContDataGet(c));
@@ -157,61 +214,17 @@ int ServerIntercept(TSCont c, TSEvent e, void * d) {
     assert(data != NULL);
     const TSVConn vconnection = static_cast< TSVConn >(d);
 
-    TSIOBuffer buffer = TSIOBufferCreate();
-    assert(buffer != NULL);
-    TSIOBufferReader reader = TSIOBufferReaderAlloc(buffer);
-    assert(reader != NULL);
-
-    if (data->version.empty()) {
-      data->version = "0";
-    }
-
-    if (data->size > 0 || data->context.size() > 0) {
-      const int size = data->size + data->context.size() + data->version.size() + 33;
-
-      std::stringstream header;
-
-      header << "HTTP/1.1 200 OK" "\r\n"
-        "Content-Type: application/javascript; charset=UTF-8" "\r\n"
-        "Content-Length: " << size << "\r\n";
-
-      if (data->cache > 0) {
-        header << "Cache-Control: max-age=" << data->cache << "\r\n";
-        TSDebug(PLUGIN_TAG, "setting Cache-Control max-age to %d seconds.", data->cache);
-      }
-
-      header << "\r\n";
-
-      {
-        const std::string h = header.str();
-        TSIOBufferWrite(buffer, h.data(), h.size());
-      }
-
-      TSIOBufferWrite(buffer, "{\"context\":{", 12);
-      TSIOBufferWrite(buffer, data->context.data(), data->context.size());
-      TSIOBufferWrite(buffer, "},\"data\":", 9);
-      assert(strlen(data->data) == data->size);
-      TSIOBufferWrite(buffer, data->data, data->size);
-      TSIOBufferWrite(buffer, ",\"version\":", 11);
-      TSIOBufferWrite(buffer, data->version.data(), data->version.size());
-      TSIOBufferWrite(buffer, "}", 1);
-
+    //a found response was already written by TSRemapDoRemap
+    if (data->size > 0) {
       TSStatIntIncrement(statistics.hits, 1);
-      TSStatIntIncrement(statistics.size, size);
-
+      TSStatIntIncrement(statistics.size, data->size);
     } else {
-      const std::string response = "HTTP/1.1 404 NOT FOUND" "\r\n"
-        "Content-Type: text/html; charset=UTF-8" "\r\n"
-        "Content-Length: 18" "\r\n"
-        "\r\n"
-        "<h2>NOT FOUND</h2>";
-
-      TSIOBufferWrite(buffer, response.data(), response.size());
+      TSIOBufferWrite(data->buffer, NOT_FOUND, sizeof(NOT_FOUND) - 1);
       TSStatIntIncrement(statistics.notFounds, 1);
     }
 
     const TSVIO vio = TSVConnWrite(vconnection, c,
-        reader, TSIOBufferReaderAvail(reader));
+        data->reader, TSIOBufferReaderAvail(data->reader));
 
     assert(vio != NULL);
 
@@ -225,7 +238,7 @@ int ServerIntercept(TSCont c, TSEvent e, void * d) {
       const long diff = (end.tv_sec - data->start.tv_sec) * 1000000
         + (end.tv_nsec - data->start.tv_nsec) / 1000;
 
-      if (data->size > 0 || data->context.size() > 0) {
+      if (data->size > 0) {
         TSStatIntIncrement(statistics.time, diff);
       }
 
@@ -256,7 +269,7 @@ TSRemapStatus TSRemapDoRemap(void * i, TSHttpTxn t, TSRemapRequestInfo *) {
   Data * data = new Data();
   assert(data != NULL);
 
-  char * const query = NULL;
+  char * query = NULL;
   Strings parameters, keys;
   const char * version = NULL;
 
@@ -277,7 +290,7 @@ TSRemapStatus TSRemapDoRemap(void * i, TSHttpTxn t, TSRemapRequestInfo *) {
 
   if (pointer != NULL) {
     assert(length > 0);
-    char * const query = new char [length + 1];
+    query = new char [length + 1];
     size_t length2;
     CHECK(TSStringPercentDecode(pointer, length, query, length, &length2));
     assert(length2 > 0);
@@ -335,7 +348,10 @@ TSRemapStatus TSRemapDoRemap(void * i, TSHttpTxn t, TSRemapRequestInfo *) {
     }
   }
 
-  Library::Pointer instance;
+  //instance stays loaded until guard goes out of scope
+  const epoch::Guard guard;
+  Instance * instance = NULL;
+  int age = 0;
 
   {
     bool hasVersion = version != NULL;
@@ -344,62 +360,159 @@ TSRemapStatus TSRemapDoRemap(void * i, TSHttpTxn t, TSRemapRequestInfo *) {
 
     if (hasVersion) {
       TSDebug(PLUGIN_TAG, "Version is %s", version);
-      instance = library->get(version);
-      data->cache = maxAge;
+      char * end = NULL;
+      const long number = strtol(version, &end, 10);
+      if (*end == '\0') {
+        instance = library->get(static_cast< int >(number));
+      }
+      age = maxAge;
     } else {
       instance = library->get();
     }
   }
 
-  if (instance) {
+  if (instance != NULL) {
     const size_t size = parameters.size();
     TSDebug(PLUGIN_TAG, "library for look-up: %s", library->file());
 
-    if (keys.empty()) {
-      instance->json(parameters.data(), size, NULL,
-          0, &(data->data), &(data->size));
+    /*
+     * entries are keyed by the dimension values the library resolves the
+     * context to. Resolving drops the parameters json() would drop, the
+     * echoed context is then the same on hits and misses.
+     */
+    cache::Cache & cache = instance->cache();
+    cache::Pointer cached;
+    std::string key;
+    bool cacheable = false;
+
+    if (cache.enabled()) {
+      uint32_t values[64];
+      const int n = instance->context(parameters.data(), size, values, 64);
+      if (n >= 0 && n <= 64) {
+        cache::key(values, n, keys, key);
+        cacheable = true;
+      }
+    }
+
+    /*
+     * the body is rendered first, the header and the context (only settled
+     * by json()) are then written into the room left in front of it. The
+     * buffer is reused by every request served on this thread.
+     */
+    static thread_local library::Buffer response;
+
+    size_t room = HEADER + 21; //{"context":{ ... },"data":
+    for (size_t j = 0; j + 1 < size; j += 2) {
+      if (parameters[j] != NULL) {
+        room += strlen(parameters[j]) + strlen(parameters[j + 1]) + 6;
+      }
+    }
+
+    response.resize(room);
+
+    if (cacheable && cache.get(key, cached)) {
+      TSStatIntIncrement(statistics.cacheHits, 1);
+      response.append(cached->data.data(), cached->data.size());
+
     } else {
-      if (unlikely(TSIsDebugTagSet(PLUGIN_TAG) > 0)) {
-        const Strings::const_iterator end = keys.end();
-        Strings::const_iterator iterator = keys.begin();
+      if (keys.empty()) {
+        instance->json(parameters.data(), size, NULL, 0, response);
+      } else {
+        if (unlikely(TSIsDebugTagSet(PLUGIN_TAG) > 0)) {
+          const Strings::const_iterator end = keys.end();
+          Strings::const_iterator iterator = keys.begin();
 
-        std::string output;
+          std::string output;
+
+          for (; iterator != end; ++iterator) {
+            output += "\n" " - ";
+            output += *iterator;
+          }
 
-        for (; iterator != end; ++iterator) {
-          output += "\n" " - ";
-          output += *iterator;
+          TSDebug(PLUGIN_TAG, "keys are:%s", output.c_str());
         }
 
-        TSDebug(PLUGIN_TAG, "keys are:%s", output.c_str());
+        instance->json(parameters.data(), size, keys.data(),
+            keys.size(), response);
       }
 
-      instance->json(parameters.data(), size, keys.data(),
-          keys.size(), &(data->data), &(data->size));
+      //the library renders nothing when it runs out of memory
+      if (response.size == room) {
+        TSError("[" PLUGIN_TAG "] %s could not render the response.",
+            library->file());
+        response.append("null");
+        cacheable = false;
+      }
+
+      if (cacheable) {
+        TSStatIntIncrement(statistics.cacheMisses, 1);
+        const std::shared_ptr< cache::Response > rendered =
+          std::make_shared< cache::Response >();
+        rendered->data.assign(response.data + room, response.size - room);
+        cache.put(key, rendered);
+      }
     }
 
     {
+      char buffer[32] = "0";
       const int version = instance->version();
       if (version > 0) {
-        char buffer[32];
         snprintf(buffer, 32, "%d", version);
-        data->version = buffer;
       }
+      response.append(",\"version\":");
+      response.append(buffer);
+      response.append("}");
     }
 
-    for (int i = 0, j = 0; i < size; i += 2) {
-      if (parameters[i] != NULL) {
-        assert(parameters[i + 1] != NULL);
-        if (j > 0) {
-          data->context += ",";
+    size_t context = 0;
+
+    for (size_t j = 0, k = 0; j + 1 < size; j += 2) {
+      if (parameters[j] != NULL) {
+        assert(parameters[j + 1] != NULL);
+        context += strlen(parameters[j]) + strlen(parameters[j + 1]) + 5 + (k++ > 0);
+      }
+    }
+
+    data->size = response.size - room + context + 21;
+
+    char header[HEADER + 1];
+    int length = snprintf(header, sizeof(header), "HTTP/1.1 200 OK" "\r\n"
+        "Content-Type: application/javascript; charset=UTF-8" "\r\n"
+        "Content-Length: %d" "\r\n", data->size);
+
+    if (age > 0) {
+      length += snprintf(header + length, sizeof(header) - length,
+          "Cache-Control: max-age=%d" "\r\n", age);
+      TSDebug(PLUGIN_TAG, "setting Cache-Control max-age to %d seconds.", age);
+    }
+
+    length += snprintf(header + length, sizeof(header) - length, "\r\n");
+    assert(length <= HEADER);
+
+    const size_t offset = room - context - 21 - length;
+    char * c = response.data + offset;
+
+    c = copy(c, header, length);
+    c = copy(c, "{\"context\":{", 12);
+
+    for (size_t j = 0, k = 0; j + 1 < size; j += 2) {
+      if (parameters[j] != NULL) {
+        if (k++ > 0) {
+          c = copy(c, ",", 1);
         }
-        data->context += "\"";
-        data->context += parameters[i];
-        data->context += "\":\"";
-        data->context += parameters[i + 1];
-        data->context += "\"";
-        ++j;
+        c = copy(c, "\"", 1);
+        c = copy(c, parameters[j], strlen(parameters[j]));
+        c = copy(c, "\":\"", 3);
+        c = copy(c, parameters[j + 1], strlen(parameters[j + 1]));
+        c = copy(c, "\"", 1);
       }
     }
+
+    c = copy(c, "},\"data\":", 9);
+    assert(c == response.data + room);
+
+    TSIOBufferWrite(data->buffer, response.data + offset,
+        response.size - offset);
   }
 
   if (query != NULL) {
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <assert.h>
+
+#include "cache.h"
+
+namespace cache {
+
+void key(const uint32_t * c, const int n, const Strings & k, std::string & o) {
+  o.append(reinterpret_cast< const char * >(c), n * sizeof(uint32_t));
+
+  //'\0' can not be part of a key, it is safe as separator
+  for (size_t j = 0; j < k.size(); ++j) {
+    o += k[j];
+    o += '\0';
+  }
+}
+
+Cache::Shard::Shard(void) : size(0) {
+  const int r = pthread_mutex_init(&mutex, NULL);
+  assert(r == 0);
+}
+
+Cache::Shard::~Shard() {
+  const int r = pthread_mutex_destroy(&mutex);
+  assert(r == 0);
+}
+
+Cache::~Cache() {
+  assert(shards_ != NULL);
+  delete [] shards_;
+}
+
+Cache::Cache(const size_t c, const int n) :
+  capacity_(c / n), n_(n), shards_(new Shard[n]) {
+  assert(n_ > 0);
+  assert(shards_ != NULL);
+}
+
+Cache::Shard & Cache::shard(const std::string & k) const {
+  //FNV-1a
+  unsigned int hash = 2166136261u;
+  for (size_t i = 0; i < k.size(); ++i) {
+    hash ^= static_cast< unsigned char >(k[i]);
+    hash *= 16777619u;
+  }
+  return shards_[hash % n_];
+}
+
+bool Cache::enabled(void) const {
+  return capacity_ > 0;
+}
+
+bool Cache::get(const std::string & k, Pointer & o) const {
+  Shard & shard = this->shard(k);
+  bool result = false;
+
+  pthread_mutex_lock(&shard.mutex);
+
+  const Entries::iterator iterator = shard.entries.find(k);
+
+  if (iterator != shard.entries.end()) {
+    shard.recency.splice(shard.recency.begin(), shard.recency,
+        iterator->second.recency);
+    o = iterator->second.value;
+    result = true;
+  }
+
+  pthread_mutex_unlock(&shard.mutex);
+
+  return result;
+}
+
+void Cache::put(const std::string & k, const Pointer & v) {
+  assert(static_cast< bool >(v));
+  const size_t size = k.size() + v->data.size();
+
+  if (size > capacity_) {
+    return;
+  }
+
+  Shard & shard = this->shard(k);
+
+  pthread_mutex_lock(&shard.mutex);
+
+  //another thread may have rendered the same response meanwhile
+  if (shard.entries.find(k) == shard.entries.end()) {
+    while (shard.size + size > capacity_) {
+      assert( ! shard.recency.empty());
+      const Entries::iterator iterator = shard.entries.find(shard.recency.back());
+      assert(iterator != shard.entries.end());
+      shard.size -= iterator->first.size() + iterator->second.value->data.size();
+      shard.entries.erase(iterator);
+      shard.recency.pop_back();
+    }
+
+    shard.recency.push_front(k);
+    Entry & entry = shard.entries[k];
+    entry.value = v;
+    entry.recency = shard.recency.begin();
+    shard.size += size;
+  }
+
+  pthread_mutex_unlock(&shard.mutex);
+}
+
+} //end of cache namespace
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+namespace cache {
+typedef std::vector< const char * > Strings;
+
+/*
+ * builds the look-up key out of the n dimension values the library resolved
+ * the context to and the requested keys. Keys keep the order they were
+ * requested in, json() renders them in that order. Parameters the library
+ * does not know do not take part in it.
+ */
+void key(const uint32_t *, const int n, const Strings &, std::string &);
+
+struct Response {
+  std::string data;
+};
+
+typedef std::shared_ptr< const Response > Pointer;
+
+/*
+ * bounded cache of rendered json() outputs. Entries are spread over shards
+ * by hash, each shard has its own lock and evicts its least recently used
+ * entries once it holds more than its share of the capacity (in bytes).
+ */
+class Cache {
+  typedef std::list< std::string > Recency;
+
+  struct Entry {
+    Pointer value;
+    Recency::iterator recency;
+  };
+
+  typedef std::map< std::string, Entry > Entries;
+
+  struct Shard {
+    pthread_mutex_t mutex;
+    Entries entries;
+    Recency recency;
+    size_t size;
+
+    Shard(void);
+    ~Shard();
+  };
+
+  const size_t capacity_;
+  const int n_;
+  Shard * const shards_;
+
+  Shard & shard(const std::string &) const;
+
+  DISALLOW_COPY_AND_ASSIGN(Cache);
+
+public:
+  ~Cache();
+  Cache(const size_t, const int n = 16);
+
+  bool enabled(void) const;
+  //copies the pointer only, o can be read after the shard is unlocked
+  bool get(const std::string &, Pointer & o) const;
+  void put(const std::string &, const Pointer &);
+};
+} //end of cache namespace
+
+#endif //CACHE_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <assert.h>
+#include <mutex>
+#include <new>
+#include <sched.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "epoch.h"
+
+namespace {
+std::atomic< uint64_t > current(1);
+
+//slots are never released, ATS threads live as long as the process
+std::mutex mutex;
+std::vector< epoch::Slot * > slots;
+
+thread_local epoch::Slot * local = NULL;
+
+epoch::Slot & slot(void) {
+  if (local == NULL) {
+    //before C++17 new does not honor alignas past alignof(max_align_t)
+    void * memory = NULL;
+    if (posix_memalign(&memory, alignof(epoch::Slot),
+          sizeof(epoch::Slot)) != 0) {
+      throw std::bad_alloc();
+    }
+    local = new (memory) epoch::Slot();
+    std::lock_guard< std::mutex > lock(mutex);
+    slots.push_back(local);
+  }
+  return *local;
+}
+} //end of anonymous namespace
+
+namespace epoch {
+
+Guard::~Guard() {
+  slot_.epoch.store(0, std::memory_order_release);
+}
+
+Guard::Guard(void) : slot_(slot()) {
+  assert(slot_.epoch.load(std::memory_order_relaxed) == 0); //no nesting
+  slot_.epoch.store(current.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+  //orders the store above before any read of published data
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void synchronize(void) {
+  const uint64_t epoch = current.fetch_add(1) + 1;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  std::vector< Slot * > copy;
+
+  {
+    std::lock_guard< std::mutex > lock(mutex);
+    copy = slots;
+  }
+
+  for (size_t i = 0; i < copy.size(); ++i) {
+    for (;;) {
+      const uint64_t e = copy[i]->epoch.load(std::memory_order_acquire);
+      if (e == 0 || e >= epoch) {
+        break;
+      }
+      sched_yield();
+    }
+  }
+}
+
+} //end of epoch namespace
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <stdint.h>
+
+#include "common.h"
+
+/*
+ * epoch based reclamation. Readers wrap their use of published data in a
+ * Guard, a writer publishes a replacement and calls synchronize() before
+ * freeing what it replaced. Readers only store to a slot of their own
+ * thread, they never write to a shared cache line.
+ */
+namespace epoch {
+
+struct alignas(64) Slot {
+  std::atomic< uint64_t > epoch; //0 outside of a Guard
+
+  Slot(void) : epoch(0) { }
+};
+
+static_assert(sizeof(Slot) == 64, "a slot fills exactly one cache line");
+static_assert(alignof(Slot) == 64, "a slot starts a cache line");
+
+class Guard {
+  Slot & slot_;
+
+  DISALLOW_COPY_AND_ASSIGN(Guard);
+
+public:
+  ~Guard();
+  Guard(void);
+};
+
+//waits for every Guard entered before the call to be left
+void synchronize(void);
+} //end of epoch namespace
+
+#endif //EPOCH_H
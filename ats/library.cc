@@ -4,14 +4,46 @@
  * See the accompanying LICENSE file for terms.
  */
 
+#include <algorithm>
 #include <assert.h>
-#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <dlfcn.h>
 
 #include "library.h"
 
 namespace library {
 
+Buffer::~Buffer() {
+  free(data);
+}
+
+void Buffer::reserve(const size_t n) {
+  if (n <= capacity) {
+    return;
+  }
+  const size_t c = std::max(n, capacity * 2);
+  char * const d = static_cast< char * >(realloc(data, c));
+  assert(d != NULL);
+  data = d;
+  capacity = c;
+}
+
+void Buffer::resize(const size_t n) {
+  reserve(n);
+  size = n;
+}
+
+void Buffer::append(const char * const s, const size_t n) {
+  reserve(size + n);
+  memcpy(data + size, s, n);
+  size += n;
+}
+
+void Buffer::append(const char * const s) {
+  append(s, strlen(s));
+}
+
 Instance::~Instance() {
   assert(handle != NULL);
   const int r = dlclose(handle);
@@ -19,6 +51,8 @@ Instance::~Instance() {
   handle = NULL;
   assert(symbols.json != NULL);
   symbols.json = NULL;
+  symbols.jsonAppend = NULL;
+  symbols.context = NULL;
   assert(symbols.version != NULL);
   symbols.version = NULL;
 }
@@ -29,72 +63,142 @@ void Instance::json(const char * * a, const int b, const char * * c,
   return (*symbols.json)(a, b, c, d, e, f);
 }
 
+void Instance::json(const char * * a, const int b, const char * * c,
+    const int d, Buffer & e) const {
+  if (symbols.jsonAppend != NULL) {
+    return (*symbols.jsonAppend)(a, b, c, d, &e.data, &e.size, &e.capacity);
+  }
+  char * f = NULL;
+  int g = 0;
+  json(a, b, c, d, &f, &g);
+  if (f != NULL) {
+    e.append(f, g);
+    free(f);
+  }
+}
+
+int Instance::context(const char * * a, const int b, uint32_t * c,
+    const int d) const {
+  if (symbols.context == NULL) {
+    return -1;
+  }
+  return (*symbols.context)(a, b, c, d);
+}
+
 int Instance::version(void) const {
   assert(symbols.version != NULL);
   return (*symbols.version)();
 }
 
+cache::Cache & Instance::cache(void) {
+  return cache_;
+}
+
+bool Library::Stamp::operator == (const Stamp & s) const {
+  return device == s.device
+    && inode == s.inode
+    && size == s.size
+    && modification.tv_sec == s.modification.tv_sec
+    && modification.tv_nsec == s.modification.tv_nsec;
+}
+
 Library::~Library() {
-  assert(instances_ != NULL);
-  delete [] instances_;
+  const Table * const table = table_.load();
+  assert(table != NULL);
+  for (size_t i = 0; i < table->instances.size(); ++i) {
+    delete table->instances[i];
+  }
+  delete table;
 }
 
-Library::Library(const char * const f, const int n) :
-  file_(f), n_(n), instances_(new Pair[n]), x_(n - 1) {
+Library::Library(const char * const f, const int n, const size_t c) :
+  file_(f), n_(n), cache_(c), table_(new Table(n)), stamp_() {
   assert(n_ > 0);
-  assert(x_ >= 0);
-  assert(instances_ != NULL);
   reload();
 }
 
-Library::Pointer Library::get(void) const {
-  return instances_[x_].second;
+Instance * Library::get(void) const {
+  const Table * const table = table_.load(std::memory_order_acquire);
+  return table->instances[table->x];
 }
 
-Library::Pointer Library::get(const std::string & s) const {
-  for (int i = 0; i < n_; ++i) {
-    Pair & pair = instances_[i];
-    if (pair.first == s) {
-      return pair.second;
-    }
-  }
-  return Pointer();
+Instance * Library::get(const int v) const {
+  const Table * const table = table_.load(std::memory_order_acquire);
+  const Versions::const_iterator iterator = table->versions.find(v);
+  return iterator != table->versions.end() ? iterator->second : NULL;
 }
 
 bool Library::reload(void) {
-  //TODO(dmorilha) only update if file content changed.
-  //HACK TO BYPASS dlopen STUPID CACHE
-  static int i = 0;
+  const Table * const previous = table_.load();
+
+  Stamp stamp = Stamp();
+  struct stat information;
+
+  if (stat(file_.c_str(), &information) == 0) {
+    stamp.device = information.st_dev;
+    stamp.inode = information.st_ino;
+    stamp.size = information.st_size;
+    stamp.modification = information.st_mtim;
+
+    if (previous->instances[previous->x] != NULL && stamp == stamp_) {
+      return false;
+    }
+  }
+
+  /*
+   * dlopen returns the already loaded library for a known path, a distinct
+   * number of leading slashes makes each load a different path. The count
+   * is shared by every Library in the process, rules pointing at the same
+   * file would otherwise get each other's handles.
+   */
+  static std::atomic< unsigned int > loads(0);
   std::string f;
-  f.append(i, '/');
-  //NO MORE THAN 100 VERSIONS
-  i = (i + 1) % 100;
+  f.append(loads++ % 1024, '/');
   f += file_;
   Instance::Handle handle = dlopen(f.c_str(), RTLD_LAZY | RTLD_LOCAL);
 
-  x_ = (x_ + 1) % n_;
+  Table * const table = new Table(*previous);
+  table->x = (previous->x + 1) % n_;
+
+  Instance * & instance = table->instances[table->x];
+  Instance * const retired = instance;
+  instance = NULL;
 
   if (handle != NULL) {
-    const int SIZE = 32;
-    char buffer[SIZE];
     void * const json = dlsym(handle, "json");
+    void * const jsonAppend = dlsym(handle, "jsonAppend");
+    void * const context = dlsym(handle, "context");
     void * const version = dlsym(handle, "version");
     if (json != NULL && version != NULL) {
-      instances_[x_].second.reset(new Instance(handle,
+      instance = new Instance(handle,
           reinterpret_cast< pointer::json >(json),
-          reinterpret_cast< pointer::version >(version)));
-
-      snprintf(buffer, SIZE, "%d",
-          instances_[x_].second->version());
-
-      instances_[x_].first = buffer;
+          reinterpret_cast< pointer::jsonAppend >(jsonAppend),
+          reinterpret_cast< pointer::context >(context),
+          reinterpret_cast< pointer::version >(version), cache_);
+      stamp_ = stamp;
+    } else {
+      dlclose(handle);
+    }
+  }
 
-      return true;
+  //oldest first, so the latest instance of a version wins
+  table->versions.clear();
+  for (int i = 1; i <= n_; ++i) {
+    Instance * const item = table->instances[(table->x + i) % n_];
+    if (item != NULL) {
+      table->versions[item->version()] = item;
     }
   }
-  instances_[x_].second.reset();
-  instances_[x_].first = "0";
-  return false;
+
+  table_.store(table);
+
+  //requests still holding previous' instances have to be done with them
+  epoch::synchronize();
+
+  delete previous;
+  delete retired;
+
+  return instance != NULL;
 }
 
 const char * Library::file(void) const {
@@ -7,60 +7,137 @@
 #ifndef LIBRARY_H
 #define LIBRARY_H
 
-#include <boost/shared_ptr.hpp>
+#include <atomic>
+#include <stdint.h>
 #include <string>
+#include <sys/stat.h>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include "cache.h"
+#include "epoch.h"
 
 namespace library {
 namespace pointer {
 typedef void (*json) (const char * *, const int,
     const char * *, const int, char * *, int *);
+typedef void (*jsonAppend) (const char * *, const int,
+    const char * *, const int, char * *, size_t *, size_t *);
+typedef int (*context) (const char * *, const int, uint32_t *, const int);
 typedef int (*version) (void);
 } //end of pointer namespace
 
+/*
+ * malloc'd bytes libraries append to through jsonAppend. Either side of the
+ * C interface grows it with realloc.
+ */
+struct Buffer {
+  char * data;
+  size_t size;
+  size_t capacity;
+
+  Buffer(void) : data(NULL), size(0), capacity(0) { }
+  ~Buffer();
+
+  void reserve(const size_t);
+  //new bytes are left uninitialized
+  void resize(const size_t);
+  void append(const char * const, const size_t);
+  void append(const char * const);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(Buffer);
+};
+
 class Instance {
   typedef void * Handle;
 
   struct Symbols {
     pointer::json json;
+    pointer::jsonAppend jsonAppend; //optional, older libraries lack it
+    pointer::context context; //optional, same
     pointer::version version;
 
-    Symbols(const pointer::json j = NULL, const pointer::version v = NULL) :
-      json(j), version(v) { }
+    Symbols(const pointer::json j = NULL, const pointer::jsonAppend a = NULL,
+        const pointer::context c = NULL, const pointer::version v = NULL) :
+      json(j), jsonAppend(a), context(c), version(v) { }
   };
 
   Handle handle;
   Symbols symbols;
 
-  Instance(const Handle h, const pointer::json j, const pointer::version v) :
-    handle(h), symbols(j, v) { }
+  //rendered outputs, dropped along with the instance on reload
+  cache::Cache cache_;
+
+  Instance(const Handle h, const pointer::json j, const pointer::jsonAppend a,
+      const pointer::context x, const pointer::version v, const size_t c) :
+    handle(h), symbols(j, a, x, v), cache_(c) { }
 
 public:
   ~Instance();
 
   void json(const char * *, const int, const char * *,
       const int, char * *, int *) const;
+  void json(const char * *, const int, const char * *,
+      const int, Buffer &) const;
+  //dimension values of the context, -1 if the library can not tell
+  int context(const char * *, const int, uint32_t *, const int) const;
   int version(void) const;
+  cache::Cache & cache(void);
 
   friend class Library;
 };
 
+/*
+ * the loaded instances are published as an immutable Table, reload()
+ * replaces it as a whole. Instances returned by get() stay valid while the
+ * calling thread holds an epoch::Guard entered before the call.
+ */
 struct Library {
-  typedef boost::shared_ptr< Instance > Pointer;
-  typedef std::pair< std::string, Pointer > Pair;
+  typedef std::vector< Instance * > Instances;
+  typedef std::unordered_map< int, Instance * > Versions;
+
+  struct Table {
+    Instances instances; //ring, NULL where loading failed
+    Versions versions; //the latest instance for each version
+    int x; //latest
+
+    Table(const int n) : instances(n, NULL), x(n - 1) { }
+  };
+
+  //identifies the file a loaded instance came from
+  struct Stamp {
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    struct timespec modification;
+
+    bool operator == (const Stamp &) const;
+  };
 
 private:
   const std::string file_;
   const int n_;
-  Pair * const instances_;
-  int x_;
+  const size_t cache_;
+  std::atomic< const Table * > table_;
+
+  //reload() only
+  Stamp stamp_;
+
+  DISALLOW_COPY_AND_ASSIGN(Library);
 
 public:
   ~Library();
-  Library(const char * const, const int n = 1);
-
-  Pointer get(void) const;
-  Pointer get(const std::string & v) const;
+  Library(const char * const, const int n = 1, const size_t c = 0);
+
+  Instance * get(void) const;
+  Instance * get(const int) const;
+  /*
+   * one thread at a time, blocks until no request uses what it replaced.
+   * Skipped while the file keeps the device, inode, size and modification
+   * time of the latest instance.
+   */
   bool reload(void);
   const char * file(void) const;
 };
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+#include "compile-cache.h"
+#include "serializer.h"
+
+namespace {
+const uint64_t VERSION = 2;
+
+//FNV-1a
+struct Hash {
+  uint64_t value;
+
+  Hash(void) : value(14695981039346656037ULL) { }
+
+  explicit Hash(const uint64_t v) : value(v) { }
+
+  void operator () (const void * const d, const size_t n) {
+    const unsigned char * const b = static_cast< const unsigned char * >(d);
+    for (size_t i = 0; i < n; ++i) {
+      value ^= b[i];
+      value *= 1099511628211ULL;
+    }
+  }
+
+  void operator () (const uint64_t v) {
+    (*this)(&v, sizeof(v));
+  }
+
+  void operator () (const std::string & s) {
+    (*this)(s.size());
+    (*this)(s.data(), s.size());
+  }
+
+  void operator () (const Value & v) {
+    (*this)(v.type);
+    (*this)(v.reset);
+    (*this)(v.ignore);
+    (*this)(v.content.str());
+    (*this)(v.alias.str());
+    (*this)(v.properties.size());
+    for (const auto & item : v.properties) {
+      (*this)(item.first.str());
+      (*this)(item.second);
+    }
+  }
+};
+
+bool read(const char * const f, std::string & o) {
+  std::ifstream stream(f, std::ios::binary);
+  if ( ! stream) {
+    return false;
+  }
+  o.assign(std::istreambuf_iterator< char >(stream),
+      std::istreambuf_iterator< char >());
+  return ! stream.bad();
+}
+
+/*
+ * the running binary, argv[0] is a last resort: it is not a path when zeus
+ * was found through PATH.
+ */
+std::string executable(const char * const argv0) {
+#if defined(__linux__)
+  return "/proc/self/exe";
+#elif defined(__APPLE__)
+  char path[4096];
+  uint32_t size = sizeof(path);
+  if (_NSGetExecutablePath(path, &size) == 0) {
+    return path;
+  }
+#endif
+  return argv0;
+}
+
+//mkdir -p
+bool createDirectory(const std::string & d) {
+  for (size_t i = 1; i <= d.size(); ++i) {
+    if (i == d.size() || d[i] == '/') {
+      const std::string prefix = d.substr(0, i);
+      if (mkdir(prefix.c_str(), 0777) != 0 && errno != EEXIST) {
+        return false;
+      }
+    }
+  }
+  struct stat s;
+  return stat(d.c_str(), &s) == 0 && S_ISDIR(s.st_mode);
+}
+
+//concurrent builds may store the same entry, rename is atomic
+void write(const std::string & p, const ir::Snapshot & s) {
+  std::ostringstream temporary;
+  temporary << p << '.' << getpid();
+
+  {
+    std::ofstream stream(temporary.str(), std::ios::binary);
+    ir::serialize(stream, s);
+    if ( ! stream) {
+      unlink(temporary.str().c_str());
+      return;
+    }
+  }
+
+  if (rename(temporary.str().c_str(), p.c_str()) != 0) {
+    unlink(temporary.str().c_str());
+  }
+}
+
+/*
+ * structures added by a key are stored with their ids as identifiers and
+ * their property types as ids, both in decimal.
+ */
+bool number(const std::string & s, Structure::ID & i) {
+  char * end = NULL;
+  const long result = strtol(s.c_str(), &end, 10);
+  i = static_cast< Structure::ID >(result);
+  return ! s.empty() && *end == '\0' && i == result;
+}
+} //end of anonymous namespace
+
+CompileCache::CompileCache(const std::string & d,
+    const std::vector< const char * > & f, char * const * const argv,
+    const int argc) : directory_(d) {
+  Hash hash;
+  hash(VERSION);
+
+  //a rebuilt zeus may process the same input differently
+  {
+    struct stat s;
+    if (stat(executable(argv[0]).c_str(), &s) == 0) {
+      hash(s.st_dev);
+      hash(s.st_ino);
+      hash(s.st_size);
+      hash(s.st_mtime);
+    }
+  }
+
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (strcmp(argv[i], "--set") == 0) {
+      hash(std::string(argv[++i]));
+    }
+  }
+
+  hash_ = hash.value;
+
+  hash(f.size());
+  std::string content;
+  for (const auto file : f) {
+    if ( ! read(file, content)) {
+      return; //leaves path_ empty, the snapshot does not get cached
+    }
+    hash(content);
+  }
+
+  char name[sizeof("/0123456789abcdef.ir")];
+  snprintf(name, sizeof(name), "/%016llx.ir",
+      static_cast< unsigned long long >(hash.value));
+  path_ = d + name;
+}
+
+std::string CompileCache::entry(const uint64_t h) const {
+  char name[sizeof("/0123456789abcdef.key")];
+  snprintf(name, sizeof(name), "/%016llx.key",
+      static_cast< unsigned long long >(h));
+  return directory_ + name;
+}
+
+bool CompileCache::open(void) const {
+  return createDirectory(directory_)
+    && access(directory_.c_str(), R_OK | W_OK | X_OK) == 0;
+}
+
+bool CompileCache::load(ir::Snapshot & s) const {
+  return ! path_.empty() && ir::load(path_.c_str(), s);
+}
+
+void CompileCache::store(const ir::Snapshot & s) const {
+  if ( ! path_.empty()) {
+    write(path_, s);
+  }
+}
+
+void CompileCache::dimensions(const dimensions::DimensionTable & t) {
+  Hash hash(hash_);
+  hash(t.index.size());
+  for (const auto & item : t.index) {
+    const auto & dimension = *item.second;
+    hash(dimension.did);
+    hash(dimension.dimension);
+    hash(dimension.skip);
+    hash(dimension.values.index.size());
+    for (const auto & value : dimension.values.index) {
+      hash(value.second->vid);
+      hash(value.second->value);
+    }
+  }
+  hash_ = hash.value;
+}
+
+uint64_t CompileCache::hash(const std::string & n, const Key & k) const {
+  Hash hash(hash_);
+  hash(n);
+
+  const Graph & g = k.graph;
+  hash(num_vertices(g));
+
+  const auto vertices = boost::vertices(g);
+  for (auto vertex = vertices.first; vertex != vertices.second; ++vertex) {
+    hash(g[*vertex]);
+    hash(out_degree(*vertex, g));
+    const auto edges = out_edges(*vertex, g);
+    for (auto edge = edges.first; edge != edges.second; ++edge) {
+      const Context & c = g[*edge];
+      hash(target(*edge, g));
+      hash(c.size());
+      for (int i = 0; i < c.size(); ++i) {
+        hash(c[i]);
+      }
+    }
+  }
+
+  return hash.value;
+}
+
+uint64_t CompileCache::hash(const uint64_t h, const StructureTable & t) const {
+  Hash hash(h);
+  hash(t.sid);
+  for (const auto & item : t.index) {
+    hash(item.first);
+    hash(item.second->structure.canonicalize());
+    hash(item.second->structure.aliases.size());
+    for (const auto & alias : item.second->structure.aliases) {
+      hash(alias);
+    }
+  }
+  return hash.value;
+}
+
+bool CompileCache::load(const uint64_t h, StructureTable & t,
+    ir::Key & k) const {
+  ir::Snapshot s;
+  if ( ! ir::load(entry(h).c_str(), s) || s.keys.size() != 1) {
+    return false;
+  }
+
+  //checks everything before touching the table
+  Structure::ID next = t.sid;
+  for (const auto & item : s.structures) {
+    Structure::ID sid;
+    if ( ! number(item.identifier, sid)
+        || (sid >= t.sid ? sid != next++ : t[sid] == nullptr)) {
+      return false;
+    }
+    for (const auto & property : item.properties) {
+      Structure::ID type;
+      if ( ! number(property.type, type)) {
+        return false;
+      }
+    }
+    for (const auto & alias : item.aliases) {
+      if (t[alias] != nullptr) {
+        return false;
+      }
+    }
+  }
+
+  for (const auto & item : s.structures) {
+    Structure::ID sid;
+    number(item.identifier, sid);
+
+    if (sid >= t.sid) {
+      Structure structure;
+      for (const auto & property : item.properties) {
+        Structure::ID type;
+        number(property.type, type);
+        structure.addProperty(type, property.property, property.kind);
+      }
+      t.insert(structure);
+    }
+
+    for (const auto & alias : item.aliases) {
+      t.alias(sid, alias);
+    }
+  }
+
+  k = std::move(s.keys.front());
+  return true;
+}
+
+void CompileCache::store(const uint64_t h, const ir::Structures & a,
+    const ir::Key & k) const {
+  ir::Snapshot s;
+  s.structures = a;
+  s.keys.push_back(k);
+  write(entry(h), s);
+}
+
+ir::Structures CompileCache::added(const StructureTable & t,
+    const Mark & m) {
+  ir::Structures result;
+
+  for (const auto & item : t.index) {
+    const Structure & structure = item.second->structure;
+
+    ir::Structure::Properties properties;
+    if (item.first >= m.sid) {
+      for (const auto & property : structure.properties) {
+        properties.emplace_back(property.identifier,
+            std::to_string(property.type), property.kind);
+      }
+    }
+
+    ir::Structure::Aliases aliases;
+    for (const auto & alias : structure.aliases) {
+      if (m.aliases.find(alias) == m.aliases.end()) {
+        aliases.push_back(alias);
+      }
+    }
+
+    if (item.first >= m.sid || ! aliases.empty()) {
+      result.emplace_back(std::to_string(item.first), properties, aliases);
+    }
+  }
+
+  return result;
+}
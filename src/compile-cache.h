@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "dimension.h"
+#include "ir.h"
+#include "key.h"
+#include "structure.h"
+
+/*
+ * keeps what the front end produced on disk, at two levels. The whole
+ * snapshot is named after a hash of the zeus binary, the content of every
+ * input file (in order) and the --set arguments, a run over the same inputs
+ * goes straight to the generator.
+ *
+ * Otherwise each key is looked up on its own, after the trimmer, by a hash
+ * of its graph, the dimension table and the structure table right before
+ * its types get extracted. Structure ids are handed out in key order, so a
+ * key only gets reused when the keys before it left the table the same. Its
+ * entry holds the ir::Key plus the structures and aliases it added, which
+ * are replayed into the table instead of running extraction, propagation
+ * and the builder.
+ */
+class CompileCache {
+public:
+  //the structure table as it was before extracting a key
+  struct Mark {
+    Structure::ID sid;
+    StructureTable::Aliases aliases;
+
+    Mark(void) : sid(StructureTable::kUserDefined) { }
+
+    explicit Mark(const StructureTable & t) :
+      sid(t.sid), aliases(t.aliases) { }
+  };
+
+private:
+  std::string directory_;
+  std::string path_;
+  uint64_t hash_;
+
+  std::string entry(const uint64_t) const;
+
+public:
+  CompileCache(const std::string &, const std::vector< const char * > &,
+      char * const * const, const int);
+
+  //creates the directory, false if it can not be written to
+  bool open(void) const;
+
+  //false if there is no usable entry
+  bool load(ir::Snapshot &) const;
+  void store(const ir::Snapshot &) const;
+
+  //dimension and value ids end up in every key
+  void dimensions(const dimensions::DimensionTable &);
+
+  //the part of a key hash that does not depend on the other keys
+  uint64_t hash(const std::string &, const Key &) const;
+  uint64_t hash(const uint64_t, const StructureTable &) const;
+
+  //false if there is no usable entry, the table is left untouched then
+  bool load(const uint64_t, StructureTable &, ir::Key &) const;
+  void store(const uint64_t, const ir::Structures &, const ir::Key &) const;
+
+  //what extracting a key added to the table since the mark
+  static ir::Structures added(const StructureTable &, const Mark &);
+};
+
+#endif //COMPILE_CACHE_H
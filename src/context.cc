@@ -4,82 +4,73 @@
  * See the accompanying LICENSE file for terms.
  */
 
-#include <algorithm>
-
-#include <boost/range/adaptors.hpp>
+#include <assert.h>
 
 #include "context.h"
 
 const Context Context::null;
 
-Context::Context(const Dimensions & d):
-  dimensions(d) { }
-
-bool Context::operator < (const Context & c) const {
-  using namespace std;
-  return lexicographical_compare(begin(dimensions), end(dimensions),
-      begin(c.dimensions), end(c.dimensions));
-}
-
-int Context::operator & (const Context & c) const {
-  const int size = dimensions.size();
-  int depth = 0;
-
-  for (int i = 0; i < size; ++i) {
-    if (dimensions[i] == c.dimensions[i]) {
-      depth++;
+Context::Context(const Dimensions & d) :
+  words_(), size_(d.size()) {
+  assert(d.size() <= kCapacity); //too many dimensions
 
-    } else {
-      break;
-    }
+  for (int i = 0; i < size_; ++i) {
+    assert(d[i] >= 0 && d[i] <= 0xffff);
+    words_[i / kLanes] |= static_cast< uint64_t >(d[i]) << (i % kLanes * 16);
   }
 
-  return depth;
+  updateDegree();
 }
 
-int Context::operator [] (const int i) const {
-  return dimensions[i];
+//index of the first dimension that differs, kCapacity if none does
+int Context::mismatch(const Context & c) const {
+  for (int i = 0; i < kWords; ++i) {
+    const uint64_t x = words_[i] ^ c.words_[i];
+    if (x != 0) {
+      return i * kLanes + __builtin_ctzll(x) / 16;
+    }
+  }
+  return kCapacity;
 }
 
-bool Context::contains(const Context & c) const {
-  const int size = dimensions.size();
-  int i = 0;
-
-  for (; i < size; ++i) {
-    if (dimensions[i] != c.dimensions[i]) {
+void Context::updateDegree(void) {
+  degree_ = 0;
+  for (int i = kWords - 1; i >= 0; --i) {
+    if (words_[i] != 0) {
+      degree_ = i * kLanes + (63 - __builtin_clzll(words_[i])) / 16 + 1;
       break;
     }
   }
+}
 
-  for (; i < size; ++i) {
-    if (dimensions[i] != 0) {
-      return false;
-    }
+/*
+ * lexicographic on the ids. Lanes past the size are 0, so when those are
+ * equal too the shorter context goes first, as a shorter vector would.
+ */
+bool Context::operator < (const Context & c) const {
+  const int i = mismatch(c);
+  if (i < kCapacity) {
+    return (*this)[i] < c[i];
   }
-
-  return true;
+  return size_ < c.size_;
 }
 
-int Context::degree(void) const {
-  using boost::adaptors::reverse;
-
-  int degree = dimensions.size();
+//length of the common prefix, within this context's size
+int Context::operator & (const Context & c) const {
+  const int i = mismatch(c);
+  return i < size_ ? i : size_;
+}
 
-  for (const auto dimension : reverse(dimensions)) {
-    if (dimension != 0) {
-      break;
-    }
-    --degree;
-  }
+//c starts with this context's dimensions that are not NONE
+bool Context::contains(const Context & c) const {
+  return degree_ <= mismatch(c);
+}
 
-  return degree;
+int Context::last(void) const {
+  return degree_ == 0 ? 0 : (*this)[degree_ - 1];
 }
 
-int Context::last() const {
-  const int d = degree();
-  assert(d >= 0);
-  if (d == 0) {
-    return 0;
-  }
-  return dimensions[d - 1];
+void Context::clear(const int i) {
+  words_[i / kLanes] &= ~(static_cast< uint64_t >(0xffff) << (i % kLanes * 16));
+  updateDegree();
 }
@@ -7,36 +7,60 @@
 #ifndef CONTEXT_H
 #define CONTEXT_H
 
+#include <stdint.h>
 #include <vector>
 
+/*
+ * one value id per dimension, 0 standing for NONE. Ids are kept inline as
+ * 16 bit lanes of four 64 bit words, so comparisons work a word at a time.
+ * Lanes past size() are 0.
+ */
 struct Context {
   typedef std::vector< int > Dimensions;
 
-  static const Context null;
+  enum {
+    kCapacity = 16, //dimensions
+    kLanes = 4, //per word
+    kWords = kCapacity / kLanes,
+  };
 
-  Dimensions dimensions;
+  static const Context null;
 
-  Context(void) { }
+  Context(void) : words_(), size_(0), degree_(0) { }
   Context(const Dimensions &);
 
   Context(const Context &) = default;
-  Context(Context &&) = default;
-
   Context & operator = (const Context &) = default;
-  Context & operator = (Context &&) = default;
 
   bool operator < (const Context &) const;
 
   bool operator == (const Context & c) const {
-    return ! (*this < c || c < *this);
+    return size_ == c.size_ && words_[0] == c.words_[0]
+      && words_[1] == c.words_[1] && words_[2] == c.words_[2]
+      && words_[3] == c.words_[3];
   }
 
   int operator & (const Context &) const;
-  int operator [] (const int) const;
+
+  int operator [] (const int i) const {
+    return (words_[i / kLanes] >> (i % kLanes * 16)) & 0xffff;
+  }
 
   bool contains(const Context &) const;
-  int degree(void) const;
+  int degree(void) const { return degree_; }
   int last(void) const;
+  int size(void) const { return size_; }
+
+  //sets dimension i to NONE
+  void clear(const int);
+
+private:
+  uint64_t words_[kWords];
+  uint8_t size_;
+  uint8_t degree_; //dimensions up to the last one that is not NONE
+
+  int mismatch(const Context &) const;
+  void updateDegree(void);
 };
 
 typedef std::vector< Context > Contexts;
@@ -6,20 +6,56 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <map>
+#include <sstream>
 
 #include "cpp-code.h"
+#include "cpp-layout.h"
+#include "cpp-table.h"
+#include "resolver.h"
+
+namespace {
+//quotes s as a C++ string literal, the compiled string has the same bytes
+std::string literal(const std::string & s) {
+  std::string result = "\"";
+  for (const unsigned char c : s) {
+    if (c == '"' || c == '\\' || c == '?') {
+      result += '\\';
+      result += c;
+    } else if (c < 0x20) {
+      result += '\\';
+      result += '0' + (c >> 6);
+      result += '0' + (c >> 3 & 7);
+      result += '0' + (c & 7);
+    } else {
+      result += c;
+    }
+  }
+  return result + "\"";
+}
+} //end of anonymous namespace
+
+size_t CPPCodeGenerator::Strings::insert(const std::string & s) {
+  const auto result = offsets.emplace(s, size);
+  if (result.second) {
+    pool.push_back(s);
+    size += s.size() + 1;
+  }
+  return result.first->second;
+}
 
-void CPPCodeGenerator::constructors(Printer & p, const ir::Structure & structure) {
+void CPPCodeGenerator::constructors(Printer & p, const ir::Structure & structure,
+    const ir::Structures & structures) {
   const auto id = identifier(structure.identifier);
 
   p << id << "::" << id << "(void)";
 
   bool first = true;
 
-  ir::Structure::Properties properties = structure.properties;
-  std::sort(std::begin(properties), std::end(properties));
+  //initialized in declaration order
+  const auto properties = cpp::layout(structure, structures);
 
-  for (const auto & property : properties) {
+  for (const ir::Structure::Property & property : properties) {
     std::string value;
 
     if (property.kind == ir::kNone) {
@@ -52,34 +88,30 @@ void CPPCodeGenerator::constructors(Printer & p, const ir::Structure & structure
     << "\n";
 }
 
-void CPPCodeGenerator::content(Printer & p, const Type::TYPES t,
-    const std::string & c) {
+void CPPCodeGenerator::content(Printer & p, const Value & v) {
 
-  switch (t) {
-  case Type::kBoolean: {
-    using namespace std;
-
-    string content;
-
-    transform(begin(c), end(c),
-        back_inserter(content), ::tolower);
-
-    assert(content == "true" || content == "false");
-
-    p << content;
+  switch (v.type) {
+  case Type::kBoolean:
+    p << (v.scalar.boolean ? "true" : "false");
     break;
-  }
 
   case Type::kFloat:
   case Type::kInteger:
-    p << c;
+    p << v.content;
     break;
 
   case Type::kObject:
     break;
 
   case Type::kString:
-    p << '"' << c << '"'; break;
+    if (view) {
+      const std::string & s = v.content;
+      p << "std::string_view(STRINGS + " << strings.insert(s) << ", "
+        << s.size() << ")";
+    } else {
+      p << '"' << v.content << '"';
+    }
+    break;
 
   case Type::kUndefined:
     //std::cerr << "type is undefined" << std::endl;
@@ -94,13 +126,17 @@ void CPPCodeGenerator::content(Printer & p, const Type::TYPES t,
 void CPPCodeGenerator::value(Printer & p, const Value & value,
     const std::string & prefix, const int t) {
   if ( ! value.properties.empty()) {
-    if (value.type == Type::kArray) {
+    if (flat && value.type == Type::kArray) {
+      flatArray(p, value, prefix, t);
+    } else if (flat && value.type == Type::kDynamic) {
+      flatMap(p, value, prefix, t);
+    } else if (value.type == Type::kArray) {
       for (const auto & item : value.properties) {
         if (item.second.ignore) {
           continue;
         }
         p << tab(t) << prefix << ".push_back(";
-        content(p, item.second.type, item.second.content);
+        content(p, item.second);
         p << ");" << "\n";
       }
     } else if (value.type == Type::kObject) {
@@ -129,15 +165,95 @@ void CPPCodeGenerator::value(Printer & p, const Value & value,
     } else {
       assert(false);
     }
-  } else if (value.type != Type::kUndefined) {
+  } else if (value.type != Type::kUndefined
+      && value.type != Type::kArray
+      && value.type != Type::kDynamic) {
     assert( ! value.content.empty() || value.type == Type::kString);
     assert( ! value.ignore);
     p << tab(t) << prefix << " = ";
-    content(p, value.type, value.content);
+    content(p, value);
     p << ";" << "\n";
   }
 }
 
+/*
+ * --cpp-flat: the items go into a static array the Array member refers to,
+ * declared through decltype since value() does not know the member type.
+ */
+void CPPCodeGenerator::flatArray(Printer & p, const Value & value,
+    const std::string & prefix, const int t) {
+  const bool empty = std::all_of(std::begin(value.properties),
+      std::end(value.properties),
+      [](const Value::Properties::value_type & i) { return i.second.ignore; });
+
+  if (empty) {
+    return;
+  }
+
+  p << tab(t) << "{" << "\n"
+    << tab(t + 1) << "static const decltype(" << prefix
+    << ")::value_type ITEMS[] = {" << "\n";
+
+  for (const auto & item : value.properties) {
+    if (item.second.ignore) {
+      continue;
+    }
+    p << tab(t + 2);
+    content(p, item.second);
+    p << "," << "\n";
+  }
+
+  p << tab(t + 1) << "};" << "\n"
+    << tab(t + 1) << prefix << " = ITEMS;" << "\n"
+    << tab(t) << "}" << "\n";
+}
+
+/*
+ * --cpp-flat: entries sorted by key in a static array, objects are built
+ * by a lambda the first time the array is initialized.
+ */
+void CPPCodeGenerator::flatMap(Printer & p, const Value & value,
+    const std::string & prefix, const int t) {
+  //std::map iterates in key order, strcmp order for the generated find()
+  std::map< std::string, const Value * > entries;
+
+  for (const auto & item : value.properties) {
+    if ( ! item.second.ignore) {
+      entries[item.first] = &item.second;
+    }
+  }
+
+  if (entries.empty()) {
+    return;
+  }
+
+  p << tab(t) << "{" << "\n"
+    << tab(t + 1) << "typedef decltype(" << prefix << ") M;" << "\n"
+    << tab(t + 1) << "static const M::value_type ENTRIES[] = {" << "\n";
+
+  for (const auto & item : entries) {
+    p << tab(t + 2) << "{\"" << item.first << "\", ";
+
+    if (item.second->type == Type::kObject) {
+      p << "[](void) -> M::mapped_type {" << "\n"
+        << tab(t + 3) << "M::mapped_type value;" << "\n";
+      this->value(p, *item.second, "value", t + 3);
+      p << tab(t + 3) << "return value;" << "\n"
+        << tab(t + 2) << "}()";
+    } else {
+      assert(item.second->type != Type::kArray
+          && item.second->type != Type::kDynamic);
+      content(p, *item.second);
+    }
+
+    p << "}," << "\n";
+  }
+
+  p << tab(t + 1) << "};" << "\n"
+    << tab(t + 1) << prefix << " = ENTRIES;" << "\n"
+    << tab(t) << "}" << "\n";
+}
+
 void CPPCodeGenerator::keyDimension(Printer & p, const ir::Key & key,
     const ir::Dimension & dimension, const ir::Dimensions & dimensions,
     const int t) {
@@ -192,22 +308,103 @@ void CPPCodeGenerator::keyDimension(Printer & p, const ir::Key & key,
   }
 }
 
-void CPPCodeGenerator::key(Printer & p, const ir::Key & key,
+/*
+ * resolves the key once per path down its dimension tree, keeps the
+ * distinct results in a pool and indexes it by context. Keys switching on
+ * more than Resolver::Table::kLimit combinations, and every key under
+ * --cpp-static, select their value with switches over the tree instead.
+ */
+void CPPCodeGenerator::keyTable(Printer & p, const ir::Key & key,
     const ir::Dimensions & dimensions) {
   const std::string type = this->type(
-      key.alias.empty() ? key.type : key.alias, key.kind);
+      key.alias.empty() ? key.type : key.alias, key.kind, key.width);
+
+  const Resolver::Table table(key);
+
+  std::vector< std::string > pool;
+  std::map< std::string, size_t > poolIndex;
+  std::vector< size_t > pools;
+  pools.reserve(table.leaves.size());
 
-  p << type << " Configuration::" << key.key << "(void) const {" << "\n";
+  for (const Value & leaf : table.leaves) {
+    std::stringstream ss;
+    Printer q(ss);
+    value(q, leaf, "value", 3);
 
-  /*
-  if (key.cache) {
-    p << tab(2) << "if (isset($this->" << key.key << ")) {" << "\n"
-      << tab(3) << "return $this->" << key.key << ";" << "\n"
-      << tab(2) << "}" << "\n";
+    const auto result = poolIndex.emplace(ss.str(), pool.size());
+    if (result.second) {
+      pool.push_back(ss.str());
+    }
+    pools.push_back(result.first->second);
+  }
+
+  p << cpp::constant(type) << " & Configuration::" << key.key << "(void) const {" << "\n"
+    << tab(1) << "static " << cpp::constant(type) << " VALUES[] = {" << "\n";
+
+  for (const auto & item : pool) {
+    p << tab(2) << "[](void) -> " << type << " {" << "\n"
+      << tab(3) << type << " value;" << "\n"
+      << item
+      << tab(3) << "return value;" << "\n"
+      << tab(2) << "}()," << "\n";
+  }
+
+  p << tab(1) << "};" << "\n";
+
+  if (table.switches.empty()) {
+    p << tab(1) << "return VALUES[0];" << "\n"
+      << "}" << "\n";
+    return;
   }
-  */
 
-  p << tab(1) << type << " value;" << "\n";
+  if (mode == cpp::kStatic || table.index.empty()) {
+    cpp::select(p, *this, key, table, pools, dimensions, "context",
+        [](const size_t i) { return "return VALUES[" + std::to_string(i) + "];"; },
+        1);
+    p << "}" << "\n";
+    return;
+  }
+
+  std::vector< size_t > index;
+  index.reserve(table.index.size());
+  for (const size_t leaf : table.index) {
+    index.push_back(pools[leaf]);
+  }
+
+  const std::string offset = cpp::maps(p, *this, table, dimensions, "context");
+
+  p << tab(1) << "static const " << cpp::unsignedType(pool.size() - 1)
+    << " INDEX[] = {";
+  cpp::array(p, index, 2);
+  p << tab(1) << "};" << "\n"
+    << tab(1) << "return VALUES[INDEX[" << offset << "]];" << "\n"
+    << "}" << "\n";
+}
+
+void CPPCodeGenerator::key(Printer & p, const ir::Key & key,
+    const ir::Dimensions & dimensions) {
+  if (mode == cpp::kTable || mode == cpp::kStatic) {
+    keyTable(p, key, dimensions);
+    return;
+  }
+
+  const std::string type = this->type(
+      key.alias.empty() ? key.type : key.alias, key.kind, key.width);
+
+  const bool cache = mode == cpp::kCache && key.cache;
+
+  if (cache) {
+    p << cpp::constant(type) << " & Configuration::" << key.key << "(void) const {" << "\n"
+      << tab(1) << "Cached< " << type << " > & cached = cache_." << key.key << ";" << "\n"
+      << tab(1) << "if (cached.cached) {" << "\n"
+      << tab(2) << "return cached.value;" << "\n"
+      << tab(1) << "}" << "\n"
+      << "\n"
+      << tab(1) << type << " & value = cached.value;" << "\n";
+  } else {
+    p << type << " Configuration::" << key.key << "(void) const {" << "\n"
+      << tab(1) << type << " value;" << "\n";
+  }
 
   value(p, key.value, "value", 1);
 
@@ -215,6 +412,10 @@ void CPPCodeGenerator::key(Printer & p, const ir::Key & key,
     keyDimension(p, key, *key.dimension, dimensions, 1);
   }
 
+  if (cache) {
+    p << tab(1) << "cached.cached = true;" << "\n";
+  }
+
   p << tab(1) << "return value;" << "\n"
     << "}" << "\n";
 }
@@ -223,33 +424,62 @@ void CPPCodeGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
 
   header(p, snapshot.namespaces);
 
-  ir::Structures structures = snapshot.structures;
+  const ir::Structures & structures = snapshot.structures;
 
   for (const auto & item : structures) {
-    constructors(p, item);
+    constructors(p, item, structures);
   }
 
   tables(p, snapshot.dimensions);
 
   context(p, snapshot.dimensions);
 
-  ir::Keys keys = snapshot.keys;
-  std::sort(std::begin(keys), std::end(keys));
+  const auto keys = sorted(snapshot.keys);
+
+  //the pool is complete only after every key went through it
+  std::stringstream ss;
+  Printer q(ss);
 
   bool first = true;
 
-  for (const auto & key : keys) {
+  for (const ir::Key & key : keys) {
     if (first) {
       first = false;
     } else {
-      p << "\n";
+      q << "\n";
     }
-    this->key(p, key, snapshot.dimensions);
+    this->key(q, key, snapshot.dimensions);
   }
 
+  if (view) {
+    pool(p);
+  }
+
+  p << ss.str();
+
   footer(p, snapshot.namespaces);
 }
 
+/*
+ * string values are views of this array, the NUL after each one keeps
+ * data() usable as a C string.
+ */
+void CPPCodeGenerator::pool(Printer & p) {
+  if (strings.pool.empty()) {
+    return;
+  }
+
+  p << "const char STRINGS[] =";
+
+  for (const auto & item : strings.pool) {
+    p << "\n"
+      << tab(1) << literal(item + '\0');
+  }
+
+  p << ";" << "\n"
+    << "\n";
+}
+
 void CPPCodeGenerator::header(Printer & p, const ir::Namespaces & n) {
   p << "#include <algorithm>" << "\n"
     << "#include <cstring>" << "\n"
@@ -264,34 +494,44 @@ void CPPCodeGenerator::header(Printer & p, const ir::Namespaces & n) {
   }
 }
 
+/*
+ * E and F stay in anonymous namespaces, configuration-json.cc declares its
+ * own E in the same namespace.
+ */
 void CPPCodeGenerator::tables(Printer & p, const ir::Dimensions & dimensions) {
-  p << "struct E {" << "\n"
+  p << "namespace {" << "\n"
+    << "struct E {" << "\n"
     << tab(1) << "const char * const key;" << "\n"
     << tab(1) << "const uint32_t value;" << "\n"
+    << tab(1) << "bool operator < (const char * const k) const {" << "\n"
+    << tab(2) << "return strcmp(key, k) < 0;" << "\n"
+    << tab(1) << "}" << "\n"
+    << tab(1) << "bool operator == (const char * const k) const {" << "\n"
+    << tab(2) << "return strcmp(key, k) == 0;" << "\n"
+    << tab(1) << "}" << "\n"
     << "};" << "\n"
     << "\n"
-    //TODO(dmorilha): can become binary search
+    //tables are emitted sorted by key, see below.
     << "uint32_t lookup(const char * const k, const E * e, const size_t s) {" << "\n"
-    << tab(1) << "for (int i = 0; i < s; ++i) {" << "\n"
-    << tab(2) << "if (strcmp(e[i].key, k) == 0) {" << "\n"
-    << tab(3) << "return e[i].value;" << "\n"
-    << tab(2) << "}" <<"\n"
+    << tab(1) << "const E * const i = std::lower_bound(e, e + s, k);" << "\n"
+    << tab(1) << "if (i != e + s && *i == k) {" << "\n"
+    << tab(2) << "return i->value;" << "\n"
     << tab(1) << "}" << "\n"
     << tab(1) << "return 0;" << "\n"
     << "}" << "\n"
+    << "} //end of anonymous namespace" << "\n"
     << "\n";
 
 
   for (const auto & dimension : dimensions) {
     const std::string className = constantify(dimension.second.dimension);
 
-    ir::DimensionEnumeration::Values values = dimension.second.values;
-    values.erase(std::begin(values));
-    std::sort(std::begin(values), std::end(values));
+    const auto values = sorted(std::next(std::begin(dimension.second.values)),
+        std::end(dimension.second.values));
 
     p << "const E " << className << "_TABLE[] = {" << "\n";
 
-    for (const auto & value : values) {
+    for (const ir::DimensionEnumeration::Value & value : values) {
       p << tab(1) << "{\"" << value.first << "\"" << ", " << value.second << "}," << "\n";
     }
 
@@ -304,7 +544,8 @@ void CPPCodeGenerator::tables(Printer & p, const ir::Dimensions & dimensions) {
 }
 
 void CPPCodeGenerator::context(Printer & p, const ir::Dimensions & dimensions) {
-  p << "struct F {" << "\n"
+  p << "namespace {" << "\n"
+    << "struct F {" << "\n"
     << tab(1) << "const char * const key;" << "\n"
     << tab(1) << "const E * const table;" << "\n"
     << tab(1) << "const int size;" << "\n"
@@ -328,11 +569,16 @@ void CPPCodeGenerator::context(Printer & p, const ir::Dimensions & dimensions) {
   }
 
   p << "};" << "\n"
+    << "} //end of anonymous namespace" << "\n"
     << "\n"
     << "Context Context::Create(const char * * v, const int n) {" << "\n"
     << tab(1) << "Context context;" << "\n"
     << tab(1) << "uint32_t * const p = reinterpret_cast< uint32_t * >(&context);" << "\n"
     << tab(1) << "for (int i = 0; i < n - 1; i += 2) {" << "\n"
+    //dropped by an earlier call
+    << tab(2) << "if (v[i] == NULL) {" << "\n"
+    << tab(3) << "continue;" << "\n"
+    << tab(2) << "}" << "\n"
     << tab(2) << "const F * const f = std::lower_bound(DIMENSIONS, DIMENSIONS + " << dimensions.size() << ", v[i]);" << "\n"
     << tab(2) << "if (f != DIMENSIONS + " << dimensions.size() << " && *f == v[i]) {" << "\n"
     << tab(3) << "const int z = lookup(v[i + 1], f->table, f->size);" << "\n"
@@ -354,31 +600,27 @@ void CPPCodeGenerator::footer(Printer & p, const ir::Namespaces & n) {
   }
 }
 
-std::string CPPCodeGenerator::type(const std::string & t, const ir::Kind k) const {
+std::string CPPCodeGenerator::type(const std::string & t, const ir::Kind k,
+    const std::string & w) const {
   std::string result;
 
-  //TODO(dmorilha): size is known, using vector is unecessary here.
   if (k == ir::kArray) {
-    result += "std::vector< ";
+    result += flat ? "Array< " : "std::vector< ";
   } else if (k == ir::kDynamic) {
-    //TODO(dmorilha): review "map< string," choice
-    result += "std::map< std::string, ";
+    result += flat ? "Map< " : "std::map< std::string, ";
   }
 
   if (t == "boolean") {
     result += "bool";
 
-  //TODO(dmorilha): what about making this configurable?
   } else if (t == "float") {
-    result += "double";
+    result += cpp::width(w, "double");
 
-  //TODO(dmorilha): what about making this configurable?
   } else if (t == "integer") {
-    result += "int64_t";
+    result += cpp::width(w, "int64_t");
 
-  //TODO(dmorilha): why not string or string view?
   } else if (t == "string") {
-    result += "const char *";
+    result += view ? "std::string_view" : "const char *";
 
   } else {
     result += t;
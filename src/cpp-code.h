@@ -7,32 +7,60 @@
 #ifndef CPP_CODE_H
 #define CPP_CODE_H
 
+#include <map>
 #include <string>
+#include <vector>
 
+#include "cpp-mode.h"
 #include "generator.h"
 #include "ir.h"
 
 struct CPPCodeGenerator : public Generator {
+  //--cpp-string-view: every distinct string once, each followed by a NUL
+  struct Strings {
+    std::vector< std::string > pool;
+    std::map< std::string, size_t > offsets;
+    size_t size;
+
+    Strings(void) : size(0) { }
+
+    size_t insert(const std::string &);
+  };
+
+  const cpp::Mode mode;
+  const bool flat;
+  const bool view;
+
+  CPPCodeGenerator(const cpp::Options & o = cpp::Options()) :
+    mode(o.mode), flat(o.flat), view(o.view) { }
+
+  Strings strings;
+
   void header(Printer &, const ir::Namespaces &);
   void footer(Printer &, const ir::Namespaces &);
   void tables(Printer &, const ir::Dimensions &);
   void context(Printer &, const ir::Dimensions &);
+  void pool(Printer &);
 
   void key(Printer &, const ir::Key &, const ir::Dimensions &);
   void keyDimension(Printer &, const ir::Key &, const ir::Dimension &,
       const ir::Dimensions &, const int);
+  void keyTable(Printer &, const ir::Key &, const ir::Dimensions &);
 
   void generate(Printer &, const ir::Snapshot &);
 
-  void content(Printer &, const Type::TYPES,
-      const std::string &);
+  void content(Printer &, const Value &);
 
   void value(Printer &, const Value &,
       const std::string &, const int);
+  void flatArray(Printer &, const Value &, const std::string &, const int);
+  void flatMap(Printer &, const Value &, const std::string &, const int);
 
-  std::string type(const std::string &, const ir::Kind k = ir::kNone) const;
+  std::string type(const std::string &, const ir::Kind k = ir::kNone,
+      const std::string & w = std::string()) const;
 
-  void constructors(Printer &, const ir::Structure &);
+  void constructors(Printer &, const ir::Structure &,
+      const ir::Structures &);
 };
 
 #endif //CPP_CODE_H
@@ -8,17 +8,18 @@
 #include <assert.h>
 
 #include "cpp-header.h"
+#include "cpp-layout.h"
 
-void CPPHeaderGenerator::structure (Printer & p, const ir::Structure & structure) {
+void CPPHeaderGenerator::structure (Printer & p, const ir::Structure & structure,
+    const ir::Structures & structures) {
   const auto id = identifier(structure.identifier);
 
   p << "struct " << id << " {" << "\n";
 
-  ir::Structure::Properties properties = structure.properties;
-  std::sort(std::begin(properties), std::end(properties));
+  const auto properties = cpp::layout(structure, structures);
 
-  for (const auto & property : properties) {
-    p << tab(1) << type(property.type, property.kind) << " "
+  for (const ir::Structure::Property & property : properties) {
+    p << tab(1) << type(property.type, property.kind, property.width) << " "
       << identifier(property.property) << ";" << "\n";
   }
 
@@ -37,8 +38,14 @@ void CPPHeaderGenerator::structure (Printer & p, const ir::Structure & structure
 
 void CPPHeaderGenerator::key(Printer & p, const ir::Key & key) {
   const std::string type = this->type(
-      key.alias.empty() ? key.type : key.alias, key.kind);
-  p << tab(1) << type << " " << key.key << "(void) const;" << "\n";
+      key.alias.empty() ? key.type : key.alias, key.kind, key.width);
+
+  if (mode == cpp::kTable || mode == cpp::kStatic
+      || (mode == cpp::kCache && key.cache)) {
+    p << tab(1) << cpp::constant(type) << " & " << key.key << "(void) const;" << "\n";
+  } else {
+    p << tab(1) << type << " " << key.key << "(void) const;" << "\n";
+  }
 }
 
 void CPPHeaderGenerator::contextClass(Printer & p, const ir::Snapshot & snapshot) {
@@ -69,28 +76,118 @@ void CPPHeaderGenerator::configurationClass(Printer & p, const ir::Snapshot & sn
     << tab(1) << "Configuration(const Context & c) : context(c) { }" << "\n"
     << "\n";
 
-  ir::Keys keys = snapshot.keys;
-  std::sort(std::begin(keys), std::end(keys));
+  const auto keys = sorted(snapshot.keys);
 
-  for (const auto & key : keys) {
+  for (const ir::Key & key : keys) {
     this->key(p, key);
   }
 
+  if (mode == cpp::kCache) {
+    cache(p, keys);
+  }
+
   p << "};" << "\n"
     << "\n";
 }
 
+/*
+ * resolved values, filled in by the accessors on first use. A Configuration
+ * is meant to serve one request, it is not safe to share between threads.
+ */
+void CPPHeaderGenerator::cache(Printer & p, const Sorted< ir::Key > & keys) {
+  p << "\n"
+    << "private:" << "\n"
+    << tab(1) << "template < class T >" << "\n"
+    << tab(1) << "struct Cached {" << "\n"
+    << tab(2) << "bool cached;" << "\n"
+    << tab(2) << "T value;" << "\n"
+    << tab(2) << "Cached(void) : cached(false), value() { }" << "\n"
+    << tab(1) << "};" << "\n"
+    << "\n"
+    << tab(1) << "struct Cache {" << "\n";
+
+  for (const ir::Key & key : keys) {
+    if (key.cache) {
+      p << tab(2) << "Cached< " << type(key.alias.empty() ? key.type : key.alias,
+          key.kind, key.width) << " > " << key.key << ";" << "\n";
+    }
+  }
+
+  p << tab(1) << "};" << "\n"
+    << "\n"
+    << tab(1) << "mutable Cache cache_;" << "\n";
+}
+
+/*
+ * read only views of arrays generated into static storage. Map entries are
+ * sorted by key, find() is a binary search.
+ */
+void CPPHeaderGenerator::containers(Printer & p) {
+  p << "template < class T >" << "\n"
+    << "struct Array {" << "\n"
+    << tab(1) << "typedef T value_type;" << "\n"
+    << tab(1) << "typedef const T * const_iterator;" << "\n"
+    << "\n"
+    << tab(1) << "Array(void) : data_(NULL), size_(0) { }" << "\n"
+    << tab(1) << "template < size_t N >" << "\n"
+    << tab(1) << "Array(const T (& a)[N]) : data_(a), size_(N) { }" << "\n"
+    << "\n"
+    << tab(1) << "const_iterator begin(void) const { return data_; }" << "\n"
+    << tab(1) << "const_iterator end(void) const { return data_ + size_; }" << "\n"
+    << tab(1) << "const T & operator [] (const size_t i) const { return data_[i]; }" << "\n"
+    << tab(1) << "const T * data(void) const { return data_; }" << "\n"
+    << tab(1) << "size_t size(void) const { return size_; }" << "\n"
+    << tab(1) << "bool empty(void) const { return size_ == 0; }" << "\n"
+    << "\n"
+    << "private:" << "\n"
+    << tab(1) << "const T * data_;" << "\n"
+    << tab(1) << "size_t size_;" << "\n"
+    << "};" << "\n"
+    << "\n"
+    << "template < class T >" << "\n"
+    << "struct Map {" << "\n"
+    << tab(1) << "struct value_type {" << "\n"
+    << tab(2) << "const char * first;" << "\n"
+    << tab(2) << "T second;" << "\n"
+    << tab(2) << "bool operator < (const char * const k) const {" << "\n"
+    << tab(3) << "return strcmp(first, k) < 0;" << "\n"
+    << tab(2) << "}" << "\n"
+    << tab(1) << "};" << "\n"
+    << "\n"
+    << tab(1) << "typedef T mapped_type;" << "\n"
+    << tab(1) << "typedef const value_type * const_iterator;" << "\n"
+    << "\n"
+    << tab(1) << "Map(void) : data_(NULL), size_(0) { }" << "\n"
+    << tab(1) << "template < size_t N >" << "\n"
+    << tab(1) << "Map(const value_type (& a)[N]) : data_(a), size_(N) { }" << "\n"
+    << "\n"
+    << tab(1) << "const_iterator begin(void) const { return data_; }" << "\n"
+    << tab(1) << "const_iterator end(void) const { return data_ + size_; }" << "\n"
+    << tab(1) << "size_t size(void) const { return size_; }" << "\n"
+    << tab(1) << "bool empty(void) const { return size_ == 0; }" << "\n"
+    << "\n"
+    << tab(1) << "const_iterator find(const char * const k) const {" << "\n"
+    << tab(2) << "const_iterator i = std::lower_bound(begin(), end(), k);" << "\n"
+    << tab(2) << "return i != end() && strcmp(i->first, k) == 0 ? i : end();" << "\n"
+    << tab(1) << "}" << "\n"
+    << "\n"
+    << "private:" << "\n"
+    << tab(1) << "const value_type * data_;" << "\n"
+    << tab(1) << "size_t size_;" << "\n"
+    << "};" << "\n"
+    << "\n";
+}
+
 void CPPHeaderGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dimension) {
 
   const std::string className = constantify(dimension.dimension);
 
-  ir::DimensionEnumeration::Values values = dimension.values;
-  std::sort(std::begin(values), std::end(values));
+  const auto values = sorted(dimension.values);
 
   p << "struct " << className << " {" << "\n"
     << tab(1) << "enum ENUM {" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(2) << constantify(value.first) << " = " << value.second << "," << "\n";
   }
 
@@ -125,13 +222,17 @@ void CPPHeaderGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
   p << "#undef D" << "\n"
     << "\n";
 
+  if (flat) {
+    containers(p);
+  }
+
   contextClass(p, snapshot);
 
   {
-    ir::Structures structures = snapshot.structures;
+    const ir::Structures & structures = snapshot.structures;
 
     for (const auto & item : structures) {
-      structure(p, item);
+      structure(p, item, structures);
     }
   }
 
@@ -143,12 +244,23 @@ void CPPHeaderGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
 void CPPHeaderGenerator::header(Printer & p, const ir::Namespaces & n) {
   p << "#ifndef CONFIGURATION_H" << "\n"
     << "#define CONFIGURATION_H" << "\n"
-    << "\n"
-    << "#include <map>" << "\n"
+    << "\n";
+
+  if (flat) {
+    p << "#include <algorithm>" << "\n"
+      << "#include <cstring>" << "\n";
+  }
+
+  p << "#include <map>" << "\n"
     << "#include <vector>" << "\n"
     << "#include <stdint.h>" << "\n"
-    << "#include <string>" << "\n"
-    << "\n";
+    << "#include <string>" << "\n";
+
+  if (view) {
+    p << "#include <string_view>" << "\n";
+  }
+
+  p << "\n";
 
   if ( ! n.empty()) {
     for (const auto & item : n) {
@@ -166,31 +278,27 @@ void CPPHeaderGenerator::footer(Printer & p, const ir::Namespaces & n) {
   p << "#endif //CONFIGURATION_H";
 }
 
-std::string CPPHeaderGenerator::type(const std::string & t, const ir::Kind k) const {
+std::string CPPHeaderGenerator::type(const std::string & t, const ir::Kind k,
+    const std::string & w) const {
   std::string result;
 
-  //TODO(dmorilha): size is known, using vector is unecessary here.
   if (k == ir::kArray) {
-    result += "std::vector< ";
+    result += flat ? "Array< " : "std::vector< ";
   } else if (k == ir::kDynamic) {
-    //TODO(dmorilha): review "map< string," choice
-    result += "std::map< std::string, ";
+    result += flat ? "Map< " : "std::map< std::string, ";
   }
 
   if (t == "boolean") {
     result += "bool";
 
-  //TODO(dmorilha): what about making this configurable?
   } else if (t == "float") {
-    result += "double";
+    result += cpp::width(w, "double");
 
-  //TODO(dmorilha): what about making this configurable?
   } else if (t == "integer") {
-    result += "int64_t";
+    result += cpp::width(w, "int64_t");
 
-  //TODO(dmorilha): why not string or string view?
   } else if (t == "string") {
-    result += "const char *";
+    result += view ? "std::string_view" : "const char *";
 
   } else {
     result += t;
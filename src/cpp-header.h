@@ -9,27 +9,38 @@
 
 #include <string>
 
+#include "cpp-mode.h"
 #include "generator.h"
 #include "ir.h"
 
 struct CPPHeaderGenerator : public Generator {
+  const cpp::Mode mode;
+  const bool flat;
+  const bool view;
+
+  CPPHeaderGenerator(const cpp::Options & o = cpp::Options()) :
+    mode(o.mode), flat(o.flat), view(o.view) { }
+
   void header(Printer &, const ir::Namespaces &);
   void footer(Printer &, const ir::Namespaces &);
 
-  void structure(Printer &, const ir::Structure &);
+  void structure(Printer &, const ir::Structure &, const ir::Structures &);
 
   void dimension(Printer &, const ir::DimensionEnumeration &);
   void dimensionClass(Printer &);
+  void containers(Printer &);
 
   void key(Printer &, const ir::Key &);
 
   void contextClass(Printer &, const ir::Snapshot &);
 
   void configurationClass(Printer &, const ir::Snapshot &);
+  void cache(Printer &, const Sorted< ir::Key > &);
 
   void generate(Printer &, const ir::Snapshot &);
 
-  std::string type(const std::string &, const ir::Kind k = ir::kNone) const;
+  std::string type(const std::string &, const ir::Kind k = ir::kNone,
+      const std::string & w = std::string()) const;
 };
 
 #endif //CPP_HEADER_H
@@ -6,61 +6,89 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
 
 #include "cpp-json-code.h"
+#include "cpp-table.h"
+#include "resolver.h"
+
+namespace {
+//same escaping the generated appendString does at run time
+void appendString(std::string & o, const std::string & s) {
+  static const char HEX[] = "0123456789abcdef";
+  o += '"';
+  for (const unsigned char c : s) {
+    switch (c) {
+    case '"': o += "\\\""; break;
+    case '\\': o += "\\\\"; break;
+    case '\n': o += "\\n"; break;
+    case '\r': o += "\\r"; break;
+    case '\t': o += "\\t"; break;
+    default:
+      if (c < 0x20) {
+        o += "\\u00";
+        o += HEX[c >> 4];
+        o += HEX[c & 0xf];
+      } else {
+        o += c;
+      }
+      break;
+    }
+  }
+  o += '"';
+}
 
+//quotes s as a C++ string literal, '?' is escaped against trigraphs
+std::string literal(const std::string & s) {
+  std::string result = "\"";
+  for (const char c : s) {
+    if (c == '"' || c == '\\' || c == '?') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result + "\"";
+}
+} //end of anonymous namespace
+
+/*
+ * emits statements appending the JSON for v to "o", constant characters
+ * are appended as literals.
+ */
 void CPPJsonCodeGenerator::content(Printer & p, const Structures & s,
-    const std::string & t, const ir::Kind & k, const std::string & v,
-    const int ta) {
+    const std::string & t, const ir::Kind & k, const std::string & w,
+    const std::string & v, const int ta) {
+
+  const std::string it = "it" + std::to_string(ta);
 
   switch (k) {
   case ir::kNone:
     break;
 
   case ir::kArray:
-    p << ";" << "\n"
-      << tab(ta) << "{" << "\n"
-      << tab(ta + 1) << "const " << type(t, k) << "::const_iterator" << "\n"
-      << tab(ta + 2) << "begin = " << v << ".begin()," << "\n"
-      << tab(ta + 2) << "end = " << v << ".end();" << "\n"
-      << tab(ta + 1) << type(t, k) << "::const_iterator it = begin;" << "\n"
-      << tab(ta + 1) << "ss << \"[\";" << "\n"
-      << tab(ta + 1) << "for (; it != end; ++it) {" << "\n"
-      << tab(ta + 2) << "if (it != begin) {" << "\n"
-      << tab(ta + 3) << "ss << \",\";" << "\n"
-      << tab(ta + 2) << "}" << "\n"
-      << tab(ta + 2) << "ss ";
-
-    content(p, s, t, ir::kNone, "(*it)", ta + 2);
-
-    p << ";" << "\n"
-      << tab(ta + 1) << "}" << "\n"
-      << tab(ta + 1) << "ss << \"]\";" << "\n"
-      << tab(ta) << "}" << "\n"
-      << tab(ta) << "ss ";
-    return;
-
   case ir::kDynamic:
-    p << ";" << "\n"
-      << tab(ta) << "{" << "\n"
-      << tab(ta + 1) << "const " << type(t, k) << "::const_iterator" << "\n"
-      << tab(ta + 2) << "begin = " << v << ".begin()," << "\n"
-      << tab(ta + 2) << "end = " << v << ".end();" << "\n"
-      << tab(ta + 1) << type(t, k) << "::const_iterator it = begin;" << "\n"
-      << tab(ta + 1) << "ss << \"{\";" << "\n"
-      << tab(ta + 1) << "for (; it != end; ++it) {" << "\n"
-      << tab(ta + 2) << "if (it != begin) {" << "\n"
-      << tab(ta + 3) << "ss << \",\";" << "\n"
-      << tab(ta + 2) << "}" << "\n"
-      << tab(ta + 2) << "ss << \"\\\"\" << it->first << \"\\\":\" ";
-
-    content(p, s, t, ir::kNone, "it->second", ta + 2);
-
-    p << ";" << "\n"
-      << tab(ta + 1) << "}" << "\n"
-      << tab(ta + 1) << "ss << \"}\";" << "\n"
-      << tab(ta) << "}" << "\n"
-      << tab(ta) << "ss ";
+    p << tab(ta) << "o += '" << (k == ir::kArray ? "[" : "{") << "';" << "\n"
+      << tab(ta) << "for (" << type(t, k, w) << "::const_iterator "
+      << it << " = " << v << ".begin(); " << it << " != " << v << ".end(); ++"
+      << it << ") {" << "\n"
+      << tab(ta + 1) << "if (" << it << " != " << v << ".begin()) {" << "\n"
+      << tab(ta + 2) << "o += ',';" << "\n"
+      << tab(ta + 1) << "}" << "\n";
+
+    if (k == ir::kArray) {
+      content(p, s, t, ir::kNone, w, "(*" + it + ")", ta + 1);
+    } else {
+      helpers_.string = true;
+      p << tab(ta + 1) << "appendString(o, " << it << "->first"
+        << (flat || view ? "" : ".c_str()") << ");" << "\n"
+        << tab(ta + 1) << "o += ':';" << "\n";
+      content(p, s, t, ir::kNone, w, it + "->second", ta + 1);
+    }
+
+    p << tab(ta) << "}" << "\n"
+      << tab(ta) << "o += '" << (k == ir::kArray ? "]" : "}") << "';" << "\n";
     return;
 
   default:
@@ -69,35 +97,226 @@ void CPPJsonCodeGenerator::content(Printer & p, const Structures & s,
 
   if (nativeType(t)) {
     if (t == "string") {
-      p << "<< \"\\\"\" << " << v << " << \"\\\"\"";
+      helpers_.string = true;
+      p << tab(ta) << "appendString(o, " << v << ");" << "\n";
     } else if (t == "boolean") {
-      p << "<< ("<< v << " ? \"true\" : \"false\")";
+      p << tab(ta) << "o += " << v << " ? \"true\" : \"false\";" << "\n";
+    } else if (t == "integer") {
+      helpers_.integer = true;
+      p << tab(ta) << "appendInteger(o, " << v << ");" << "\n";
     } else {
-      p << "<< " << v;
+      helpers_.floating = true;
+      p << tab(ta) << "appendFloat(o, " << v << ");" << "\n";
     }
   } else {
     const Structures::const_iterator it = s.find(t);
     assert(it != s.end());
-    p << "<< \"{\"" << "\n";
-    if ( ! it->second.properties.empty()) {
+    if (it->second->properties.empty()) {
+      p << tab(ta) << "o += \"{}\";" << "\n";
+      return;
+    }
+    bool first = true;
+    for (const auto & item : it->second->properties) {
+      p << tab(ta) << "o += \"" << (first ? "{" : ",")
+        << "\\\"" << item.property << "\\\":\";" << "\n";
+      content(p, s, item.type, item.kind, item.width, v + "." + item.property,
+          ta);
+      first = false;
+    }
+    p << tab(ta) << "o += '}';" << "\n";
+  }
+}
+
+/*
+ * what content() emits code for, evaluated at compile time. Missing values
+ * serialize as the defaults generated constructors initialize them to.
+ */
+void CPPJsonCodeGenerator::serialize(std::string & o, const Structures & s,
+    const std::string & t, const ir::Kind & k, const Value * v) {
+
+  switch (k) {
+  case ir::kNone:
+    break;
+
+  case ir::kArray:
+    o += '[';
+    if (v != NULL) {
       bool first = true;
-      for (const auto & item : it->second.properties) {
-        if (first) {
-          first = false;
-        } else {
-          p << " << \",\"" << "\n";
+      for (const auto & item : v->properties) {
+        if ( ! first) {
+          o += ',';
         }
-        p << tab(ta + 1) << "<< \"\\\"" << item.property << "\\\":\" ";
-        content(p, s, item.type, item.kind, v + "." + item.property, ta);
+        serialize(o, s, t, ir::kNone, &item.second);
+        first = false;
+      }
+    }
+    o += ']';
+    return;
+
+  case ir::kDynamic: {
+    //std::map iterates in key order
+    std::map< std::string, const Value * > properties;
+    if (v != NULL) {
+      for (const auto & item : v->properties) {
+        properties[item.first] = &item.second;
+      }
+    }
+    o += '{';
+    bool first = true;
+    for (const auto & item : properties) {
+      if ( ! first) {
+        o += ',';
       }
-      p << "\n";
+      appendString(o, item.first);
+      o += ':';
+      serialize(o, s, t, ir::kNone, item.second);
+      first = false;
     }
-    p << tab(ta + 1) << "<< \"}\"";
+    o += '}';
+    return;
+  }
+
+  default:
+    assert(false); //UNRECHEABLE
+  }
+
+  const bool empty = v == NULL || v->type == Type::kUndefined;
+
+  if (nativeType(t)) {
+    if (t == "string") {
+      appendString(o, empty ? "" : v->content);
+    } else if (t == "boolean") {
+      o += ! empty && v->scalar.boolean ? "true" : "false";
+    } else if (t == "integer") {
+      o += std::to_string(empty ? 0 : v->scalar.integer);
+    } else {
+      char buffer[32];
+      const int n = snprintf(buffer, sizeof(buffer), "%g",
+          empty ? 0.0 : v->scalar.floating);
+      o.append(buffer, n);
+    }
+  } else {
+    const Structures::const_iterator it = s.find(t);
+    assert(it != s.end());
+    o += '{';
+    bool first = true;
+    for (const auto & item : it->second->properties) {
+      const Value * property = NULL;
+      if ( ! empty) {
+        for (const auto & p : v->properties) {
+          if (p.first == item.property) {
+            property = &p.second;
+          }
+        }
+      }
+      if ( ! first) {
+        o += ',';
+      }
+      appendString(o, item.property);
+      o += ':';
+      serialize(o, s, item.type, item.kind, property);
+      first = false;
+    }
+    o += '}';
   }
 }
 
-void CPPJsonCodeGenerator::all(Printer & p, const ir::Keys & keys) {
-  p << "typedef std::string & (ConfigurationJson::* Pointer) (std::string &);" << "\n"
+void CPPJsonCodeGenerator::helpers(Printer & p) {
+  const Helpers & used = helpers_;
+
+  if ( ! (used.string || used.integer || used.floating)) {
+    return;
+  }
+
+  p << "namespace {" << "\n";
+
+  if (used.string) {
+    escape(p);
+  }
+
+  //appendFloat writes integral values through appendInteger
+  if (used.integer || used.floating) {
+    p << "void appendInteger(JsonBuffer & o, const int64_t v) {" << "\n"
+      << tab(1) << "char buffer[20];" << "\n"
+      << tab(1) << "char * const end = buffer + sizeof(buffer);" << "\n"
+      << tab(1) << "char * c = end;" << "\n"
+      << tab(1) << "uint64_t u = v < 0 ? 0 - static_cast< uint64_t >(v) : v;" << "\n"
+      << tab(1) << "do {" << "\n"
+      << tab(2) << "*--c = '0' + u % 10;" << "\n"
+      << tab(2) << "u /= 10;" << "\n"
+      << tab(1) << "} while (u != 0);" << "\n"
+      << tab(1) << "if (v < 0) {" << "\n"
+      << tab(2) << "*--c = '-';" << "\n"
+      << tab(1) << "}" << "\n"
+      << tab(1) << "o.append(c, end - c);" << "\n"
+      << "}" << "\n"
+      << "\n";
+  }
+
+  //same output as std::ostream's default formatting (%g)
+  if (used.floating) {
+    p << "void appendFloat(JsonBuffer & o, const double v) {" << "\n"
+      << tab(1) << "if (v > -1e6 && v < 1e6 && v == static_cast< int64_t >(v)" << "\n"
+      << tab(3) << "&& (v != 0 || ! std::signbit(v))) {" << "\n"
+      << tab(2) << "appendInteger(o, static_cast< int64_t >(v));" << "\n"
+      << tab(2) << "return;" << "\n"
+      << tab(1) << "}" << "\n"
+      << tab(1) << "char buffer[32];" << "\n"
+      << tab(1) << "const int n = snprintf(buffer, sizeof(buffer), \"%g\", v);" << "\n"
+      << tab(1) << "o.append(buffer, n);" << "\n"
+      << "}" << "\n"
+      << "\n";
+  }
+
+  p << "} //end of anonymous namespace" << "\n"
+    << "\n";
+}
+
+void CPPJsonCodeGenerator::escape(Printer & p) {
+  //views know their length, only C strings have to be scanned for the NUL
+  if (view) {
+    p << "void appendString(JsonBuffer & o, const std::string_view v) {" << "\n"
+      << tab(1) << "static const char HEX[] = \"0123456789abcdef\";" << "\n"
+      << tab(1) << "const char * s = v.data();" << "\n"
+      << tab(1) << "const char * const e = s + v.size();" << "\n"
+      << tab(1) << "const char * a = s;" << "\n"
+      << tab(1) << "o += '\"';" << "\n"
+      << tab(1) << "for (; s != e; ++s) {" << "\n";
+  } else {
+    p << "void appendString(JsonBuffer & o, const char * s) {" << "\n"
+      << tab(1) << "static const char HEX[] = \"0123456789abcdef\";" << "\n"
+      << tab(1) << "const char * a = s;" << "\n"
+      << tab(1) << "o += '\"';" << "\n"
+      << tab(1) << "for (; *s != '\\0'; ++s) {" << "\n";
+  }
+
+  p << tab(2) << "const unsigned char c = *s;" << "\n"
+    << tab(2) << "if (c >= 0x20 && c != '\"' && c != '\\\\') {" << "\n"
+    << tab(3) << "continue;" << "\n"
+    << tab(2) << "}" << "\n"
+    << tab(2) << "o.append(a, s - a);" << "\n"
+    << tab(2) << "a = s + 1;" << "\n"
+    << tab(2) << "switch (c) {" << "\n"
+    << tab(2) << "case '\"': o += \"\\\\\\\"\"; break;" << "\n"
+    << tab(2) << "case '\\\\': o += \"\\\\\\\\\"; break;" << "\n"
+    << tab(2) << "case '\\n': o += \"\\\\n\"; break;" << "\n"
+    << tab(2) << "case '\\r': o += \"\\\\r\"; break;" << "\n"
+    << tab(2) << "case '\\t': o += \"\\\\t\"; break;" << "\n"
+    << tab(2) << "default:" << "\n"
+    << tab(3) << "o += \"\\\\u00\";" << "\n"
+    << tab(3) << "o += HEX[c >> 4];" << "\n"
+    << tab(3) << "o += HEX[c & 0xf];" << "\n"
+    << tab(3) << "break;" << "\n"
+    << tab(2) << "}" << "\n"
+    << tab(1) << "}" << "\n"
+    << tab(1) << "o.append(a, s - a);" << "\n"
+    << tab(1) << "o += '\"';" << "\n"
+    << "}" << "\n"
+    << "\n";
+}
+
+void CPPJsonCodeGenerator::all(Printer & p, const Sorted< ir::Key > & keys) {
+  p << "typedef JsonBuffer & (ConfigurationJson::* Pointer) (JsonBuffer &);" << "\n"
     << "\n"
     << "struct E {" << "\n"
     << tab(1) << "const char * const key;" << "\n"
@@ -112,13 +331,13 @@ void CPPJsonCodeGenerator::all(Printer & p, const ir::Keys & keys) {
     << "\n"
     << "const E KEYS[] = {" << "\n";
 
-  for (const auto & key : keys) {
+  for (const ir::Key & key : keys) {
     p << tab(1) << "{\"" << key.key << "\"" << ", &ConfigurationJson::" << key.key << "}," << "\n";
   }
 
   p << "};" << "\n"
     << "\n"
-    << "std::string & ConfigurationJson::keys(const char * * k, const int s, std::string & o) {" << "\n"
+    << "JsonBuffer & ConfigurationJson::keys(const char * * k, const int s, JsonBuffer & o) {" << "\n"
     << tab(1) << "o += \"{\";" << "\n"
     << tab(1) << "bool first = true;" << "\n"
     << tab(1) << "for (int i = 0; i < s; ++i) {" << "\n"
@@ -143,7 +362,7 @@ void CPPJsonCodeGenerator::all(Printer & p, const ir::Keys & keys) {
     << tab(1) << "return o;" << "\n"
     << "}" << "\n"
     << "\n"
-    << "std::string & ConfigurationJson::all(std::string & o) {" << "\n"
+    << "JsonBuffer & ConfigurationJson::all(JsonBuffer & o) {" << "\n"
     << tab(1) << "o += \"{\";" << "\n";
 
   if (keys.size() > 0) {
@@ -166,43 +385,143 @@ void CPPJsonCodeGenerator::all(Printer & p, const ir::Keys & keys) {
 
 void CPPJsonCodeGenerator::key(Printer & p, const ir::Key & key,
     const Structures & s) {
-  const std::string type = this->type(key.type, key.kind);
+  const std::string type = this->type(key.type, key.kind, key.width);
 
-  p << "std::string & ConfigurationJson::" << key.key << "(std::string & o) {" << "\n";
+  p << "JsonBuffer & ConfigurationJson::" << key.key << "(JsonBuffer & o) {" << "\n";
 
-  p << tab(1) << type << " value = configuration_."
-    << key.key << "();" << "\n"
-    << tab(1) << "std::stringstream ss;" << "\n";
+  //binds to a returned value as well as to a returned reference
+  p << tab(1) << cpp::constant(type) << " & value = configuration_."
+    << key.key << "();" << "\n";
 
-  p << tab(1) << "ss ";
+  content(p, s, key.type, key.kind, key.width, "value", 1);
 
-  content(p, s, key.type, key.kind, "value", 1);
+  p << tab(1) << "return o;" << "\n"
+    << "}" << "\n";
+}
 
-  p << ";" << "\n"
-    << tab(1) << "o += ss.str();" << "\n"
-    << tab(1) << "return o;" << "\n"
+size_t CPPJsonCodeGenerator::Fragments::insert(const std::string & f) {
+  const auto result = index.emplace(f, pool.size());
+  if (result.second) {
+    pool.push_back(f);
+  }
+  return result.first->second;
+}
+
+/*
+ * serializes the key once per path down its dimension tree, same as
+ * CPPCodeGenerator::keyTable, and indexes the resulting fragments by
+ * context or selects them with switches over the tree.
+ */
+void CPPJsonCodeGenerator::keyTable(Printer & p, const ir::Key & key,
+    const Structures & s, const ir::Dimensions & dimensions,
+    Fragments & f) {
+  const Resolver::Table table(key);
+
+  std::vector< size_t > pools;
+  pools.reserve(table.leaves.size());
+  size_t max = 0;
+
+  for (const Value & value : table.leaves) {
+    std::string fragment;
+    serialize(fragment, s, key.type, key.kind, &value);
+    pools.push_back(f.insert(fragment));
+    max = std::max(max, pools.back());
+  }
+
+  p << "JsonBuffer & ConfigurationJson::" << key.key << "(JsonBuffer & o) {" << "\n";
+
+  if (table.switches.empty()) {
+    p << tab(1) << "const F & f = FRAGMENTS[" << pools.front() << "];" << "\n";
+
+  } else if (table.index.empty()) {
+    cpp::select(p, *this, key, table, pools, dimensions,
+        "configuration_.context", [](const size_t i) {
+          const std::string f = "FRAGMENTS[" + std::to_string(i) + "]";
+          return "return o.append(" + f + ".data, " + f + ".size);";
+        }, 1);
+    p << "}" << "\n";
+    return;
+
+  } else {
+    std::vector< size_t > index;
+    index.reserve(table.index.size());
+    for (const size_t leaf : table.index) {
+      index.push_back(pools[leaf]);
+    }
+
+    const std::string offset = cpp::maps(p, *this, table, dimensions,
+        "configuration_.context");
+
+    p << tab(1) << "static const " << cpp::unsignedType(max)
+      << " INDEX[] = {";
+    cpp::array(p, index, 2);
+    p << tab(1) << "};" << "\n"
+      << tab(1) << "const F & f = FRAGMENTS[INDEX[" << offset << "]];" << "\n";
+  }
+
+  p << tab(1) << "return o.append(f.data, f.size);" << "\n"
     << "}" << "\n";
 }
 
+void CPPJsonCodeGenerator::fragments(Printer & p, const Fragments & f) {
+  p << "namespace {" << "\n"
+    << "struct F {" << "\n"
+    << tab(1) << "const char * const data;" << "\n"
+    << tab(1) << "const size_t size;" << "\n"
+    << "};" << "\n"
+    << "\n"
+    << "const F FRAGMENTS[] = {" << "\n";
+
+  for (const auto & item : f.pool) {
+    p << tab(1) << "{" << literal(item) << ", " << item.size() << "}," << "\n";
+  }
+
+  p << "};" << "\n"
+    << "} //end of anonymous namespace" << "\n"
+    << "\n";
+}
+
 void CPPJsonCodeGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
 
-  ir::Keys keys = snapshot.keys;
-  std::sort(std::begin(keys), std::end(keys));
+  const auto keys = sorted(snapshot.keys);
 
-  const bool hasKeys = std::find(std::begin(keys),
-      std::end(keys), "keys") != std::end(keys);
+  const bool hasKeys = std::find(std::begin(snapshot.keys),
+      std::end(snapshot.keys), "keys") != std::end(snapshot.keys);
 
   header(p, snapshot.namespaces, hasKeys);
 
   Structures structures;
 
   for (const auto & item : snapshot.structures) {
-    structures.insert(make_pair(item.identifier, item));
+    structures.insert(make_pair(item.identifier, &item));
   }
 
-  for (const auto & key : keys) {
-    this->key(p, key, structures);
-    p << "\n";
+  if (mode == cpp::kTable) {
+    //the pool is complete only after every key went through it
+    Fragments fragments;
+    std::stringstream ss;
+    Printer q(ss);
+
+    for (const ir::Key & key : keys) {
+      keyTable(q, key, structures, snapshot.dimensions, fragments);
+      q << "\n";
+    }
+
+    this->fragments(p, fragments);
+    p << ss.str();
+
+  } else {
+    //helpers are known only after every key went through content()
+    std::stringstream ss;
+    Printer q(ss);
+
+    for (const ir::Key & key : keys) {
+      this->key(q, key, structures);
+      q << "\n";
+    }
+
+    helpers(p);
+    p << ss.str();
   }
 
   this->all(p, keys);
@@ -222,20 +541,19 @@ void CPPJsonCodeGenerator::header(Printer & p, const ir::Namespaces & n,
   }
 
   p << "#include <algorithm>" << "\n"
+    << "#include <cmath>" << "\n"
+    << "#include <cstdio>" << "\n"
     << "#include <cstdlib>" << "\n"
     << "#include <cstring>" << "\n"
-    << "#include <sstream>" << "\n"
     << "\n"
     << "#include \"configuration-json.h\"" << "\n"
     << "\n"
-    //TODO(dmorilha): this code to be reviewed
-    << "extern \"C\" {" << "\n"
-    << "void json(const char * * v, const int a, const char * * k," << "\n"
-    << tab(2) << "const int b, char * * o, int * s) {" << "\n"
+    << "namespace {" << "\n"
+    << "void render(const char * * v, const int a, const char * * k," << "\n"
+    << tab(2) << "const int b, " << ns << "::JsonBuffer & c) {" << "\n"
     << tab(1) << "using namespace " << ns << ";" << "\n"
     << tab(1) << "Context context = Context::Create(v, a);" << "\n"
     << tab(1) << "ConfigurationJson json(context);" << "\n"
-    << tab(1) << "std::string c;" << "\n"
     << tab(1) << "if (k != NULL || b > 0) {" << "\n"
     << tab(2) << "if (*k[0] == '*') {" << "\n"
     << tab(3) << "json.all(c);" << "\n"
@@ -244,7 +562,17 @@ void CPPJsonCodeGenerator::header(Printer & p, const ir::Namespaces & n,
     << tab(2) << "}" << "\n"
     << tab(1) << "} else {" << "\n";
 
-  if (k) {
+  if (k && (flat || view)) {
+    //json.keys() takes C strings and clears the ones it drops
+    p << tab(2) << "Configuration configuration(context);" << "\n"
+      << tab(2) << "const auto & a = configuration.keys();" << "\n"
+      << tab(2) << "std::vector< const char * > keys;" << "\n"
+      << tab(2) << "keys.reserve(a.size());" << "\n"
+      << tab(2) << "for (const auto & i : a) {" << "\n"
+      << tab(3) << "keys.push_back(i" << (view ? ".data()" : "") << ");" << "\n"
+      << tab(2) << "}" << "\n"
+      << tab(2) << "json.keys(keys.data(), keys.size(), c);" << "\n";
+  } else if (k) {
     p << tab(2) << "Configuration configuration(context);" << "\n"
       << tab(2) << "typedef std::vector< const char * > Keys;" << "\n"
       << tab(2) << "Keys keys = configuration.keys();" << "\n"
@@ -254,10 +582,57 @@ void CPPJsonCodeGenerator::header(Printer & p, const ir::Namespaces & n,
   }
 
   p << tab(1) << "}" << "\n"
-    << tab(1) << "*o = static_cast< char * >(malloc(c.size() + 1));" << "\n"
-    << tab(1) << "std::copy(c.data(), c.data() + c.size(), *o);" << "\n"
-    << tab(1) << "*s = c.size();" << "\n"
-    << tab(1) << "(*o)[*s] = '\\0';" << "\n"
+    << "}" << "\n"
+    << "} //end of anonymous namespace" << "\n"
+    << "\n"
+    //TODO(dmorilha): this code to be reviewed
+    << "extern \"C\" {" << "\n"
+    //appends to the caller's malloc'd buffer, growing it with realloc
+    << "void jsonAppend(const char * * v, const int a, const char * * k," << "\n"
+    << tab(2) << "const int b, char * * d, size_t * s, size_t * c) {" << "\n"
+    << tab(1) << ns << "::JsonBuffer o(*d, *s, *c);" << "\n"
+    //exceptions can not cross into C, a failed render appends nothing
+    << tab(1) << "try {" << "\n"
+    << tab(2) << "render(v, a, k, b, o);" << "\n"
+    << tab(1) << "} catch (...) {" << "\n"
+    << tab(2) << "o.size = *s;" << "\n"
+    << tab(1) << "}" << "\n"
+    << tab(1) << "*d = o.data;" << "\n"
+    << tab(1) << "*s = o.size;" << "\n"
+    << tab(1) << "*c = o.capacity;" << "\n"
+    << "}" << "\n"
+    << "\n"
+    //the caller frees the buffer the response was rendered in, as it is
+    << "void json(const char * * v, const int a, const char * * k," << "\n"
+    << tab(2) << "const int b, char * * o, int * s) {" << "\n"
+    //starts at what the largest response on this thread needed so far
+    << tab(1) << "static thread_local size_t capacity = 0;" << "\n"
+    << tab(1) << ns << "::JsonBuffer c;" << "\n"
+    //a failed render hands back NULL
+    << tab(1) << "try {" << "\n"
+    << tab(2) << "c.reserve(capacity);" << "\n"
+    << tab(2) << "render(v, a, k, b, c);" << "\n"
+    << tab(2) << "c += '\\0';" << "\n"
+    << tab(1) << "} catch (...) {" << "\n"
+    << tab(2) << "free(c.data);" << "\n"
+    << tab(2) << "*o = NULL;" << "\n"
+    << tab(2) << "*s = 0;" << "\n"
+    << tab(2) << "return;" << "\n"
+    << tab(1) << "}" << "\n"
+    << tab(1) << "if (c.size > capacity) {" << "\n"
+    << tab(2) << "capacity = c.size;" << "\n"
+    << tab(1) << "}" << "\n"
+    << tab(1) << "*o = c.data;" << "\n"
+    << tab(1) << "*s = c.size - 1;" << "\n"
+    << "}" << "\n"
+    << "\n"
+    //the dimension values json() would see, what callers key caches on
+    << "int context(const char * * v, const int a, uint32_t * o, const int s) {" << "\n"
+    << tab(1) << "using namespace " << ns << ";" << "\n"
+    << tab(1) << "const Context context = Context::Create(v, a);" << "\n"
+    << tab(1) << "const int n = sizeof(Context) / sizeof(uint32_t);" << "\n"
+    << tab(1) << "memcpy(o, &context, std::min(n, s) * sizeof(uint32_t));" << "\n"
+    << tab(1) << "return n;" << "\n"
     << "}" << "\n"
     << "\n"
     << "#ifndef VERSION" << "\n"
@@ -284,31 +659,27 @@ void CPPJsonCodeGenerator::footer(Printer & p, const ir::Namespaces & n) {
   }
 }
 
-std::string CPPJsonCodeGenerator::type(const std::string & t, const ir::Kind k) const {
+std::string CPPJsonCodeGenerator::type(const std::string & t, const ir::Kind k,
+    const std::string & w) const {
   std::string result;
 
-  //TODO(dmorilha): size is known, using vector is unecessary here.
   if (k == ir::kArray) {
-    result += "std::vector< ";
+    result += flat ? "Array< " : "std::vector< ";
   } else if (k == ir::kDynamic) {
-    //TODO(dmorilha): review "map< string," choice
-    result += "std::map< std::string, ";
+    result += flat ? "Map< " : "std::map< std::string, ";
   }
 
   if (t == "boolean") {
     result += "bool";
 
-  //TODO(dmorilha): what about making this configurable?
   } else if (t == "float") {
-    result += "double";
+    result += cpp::width(w, "double");
 
-  //TODO(dmorilha): what about making this configurable?
   } else if (t == "integer") {
-    result += "int64_t";
+    result += cpp::width(w, "int64_t");
 
-  //TODO(dmorilha): why not string or string view?
   } else if (t == "string") {
-    result += "const char *";
+    result += view ? "std::string_view" : "const char *";
 
   } else {
     result += t;
@@ -7,27 +7,67 @@
 #ifndef CPP_JSON_CODE_H
 #define CPP_JSON_CODE_H
 
+#include <map>
 #include <string>
+#include <vector>
 
+#include "cpp-mode.h"
 #include "generator.h"
 #include "ir.h"
+#include "value.h"
 
 struct CPPJsonCodeGenerator : public Generator {
-  typedef std::map< std::string, ir::Structure > Structures;
+  typedef std::map< std::string, const ir::Structure * > Structures;
+
+  //distinct JSON fragments shared by every key
+  struct Fragments {
+    std::vector< std::string > pool;
+    std::map< std::string, size_t > index;
+
+    size_t insert(const std::string &);
+  };
+
+  //run time helpers content() emitted calls to, helpers() prints only those
+  struct Helpers {
+    bool string;
+    bool integer;
+    bool floating;
+
+    Helpers(void) : string(false), integer(false), floating(false) { }
+  };
+
+  const cpp::Mode mode;
+  const bool flat;
+  const bool view;
+
+  CPPJsonCodeGenerator(const cpp::Options & o = cpp::Options()) :
+    mode(o.mode), flat(o.flat), view(o.view) { }
+
+  Helpers helpers_;
 
   void header(Printer &, const ir::Namespaces &, const bool k = false);
   void footer(Printer &, const ir::Namespaces &);
 
-  void all(Printer &, const ir::Keys &);
+  void all(Printer &, const Sorted< ir::Key > &);
+  void helpers(Printer &);
+  void escape(Printer &);
 
   void key(Printer &, const ir::Key &, const Structures &);
+  void keyTable(Printer &, const ir::Key &, const Structures &,
+      const ir::Dimensions &, Fragments &);
+  void fragments(Printer &, const Fragments &);
 
   void generate(Printer &, const ir::Snapshot &);
 
   void content(Printer &, const Structures &, const std::string &,
-      const ir::Kind &, const std::string &, const int);
+      const ir::Kind &, const std::string &, const std::string &,
+      const int);
+
+  void serialize(std::string &, const Structures &, const std::string &,
+      const ir::Kind &, const Value *);
 
-  std::string type(const std::string &, const ir::Kind k = ir::kNone) const;
+  std::string type(const std::string &, const ir::Kind k = ir::kNone,
+      const std::string & w = std::string()) const;
 
   bool nativeType(const std::string & s) const {
     return s == "boolean"
@@ -11,7 +11,53 @@
 
 void CPPJsonHeaderGenerator::key(Printer & p, const ir::Key & key) {
   const std::string type = this->type(key.type, key.kind);
-  p << tab(1) << "std::string & " << key.key << "(std::string &);" << "\n";
+  p << tab(1) << "JsonBuffer & " << key.key << "(JsonBuffer &);" << "\n";
+}
+
+/*
+ * malloc'd output of the printers, grown with realloc. It owns nothing,
+ * json() hands the bytes to the caller as they are, without a copy.
+ */
+void CPPJsonHeaderGenerator::buffer(Printer & p) {
+  p << "struct JsonBuffer {" << "\n"
+    << tab(1) << "char * data;" << "\n"
+    << tab(1) << "size_t size;" << "\n"
+    << tab(1) << "size_t capacity;" << "\n"
+    << "\n"
+    << tab(1) << "JsonBuffer(char * d = NULL, const size_t s = 0, const size_t c = 0) :" << "\n"
+    << tab(2) << "data(d), size(s), capacity(c) { }" << "\n"
+    << "\n"
+    << tab(1) << "void reserve(const size_t n) {" << "\n"
+    << tab(2) << "if (n <= capacity) {" << "\n"
+    << tab(3) << "return;" << "\n"
+    << tab(2) << "}" << "\n"
+    << tab(2) << "const size_t c = std::max(n, capacity * 2);" << "\n"
+    << tab(2) << "char * const d = static_cast< char * >(realloc(data, c));" << "\n"
+    << tab(2) << "if (d == NULL) {" << "\n"
+    << tab(3) << "throw std::bad_alloc();" << "\n"
+    << tab(2) << "}" << "\n"
+    << tab(2) << "data = d;" << "\n"
+    << tab(2) << "capacity = c;" << "\n"
+    << tab(1) << "}" << "\n"
+    << "\n"
+    << tab(1) << "JsonBuffer & append(const char * const s, const size_t n) {" << "\n"
+    << tab(2) << "reserve(size + n);" << "\n"
+    << tab(2) << "memcpy(data + size, s, n);" << "\n"
+    << tab(2) << "size += n;" << "\n"
+    << tab(2) << "return *this;" << "\n"
+    << tab(1) << "}" << "\n"
+    << "\n"
+    << tab(1) << "JsonBuffer & operator += (const char * const s) {" << "\n"
+    << tab(2) << "return append(s, strlen(s));" << "\n"
+    << tab(1) << "}" << "\n"
+    << "\n"
+    << tab(1) << "JsonBuffer & operator += (const char c) {" << "\n"
+    << tab(2) << "reserve(size + 1);" << "\n"
+    << tab(2) << "data[size++] = c;" << "\n"
+    << tab(2) << "return *this;" << "\n"
+    << tab(1) << "}" << "\n"
+    << "};" << "\n"
+    << "\n";
 }
 
 void CPPJsonHeaderGenerator::configurationClass(Printer & p, const ir::Snapshot & snapshot) {
@@ -22,23 +68,23 @@ void CPPJsonHeaderGenerator::configurationClass(Printer & p, const ir::Snapshot
     << " : configuration_(c) { }" << "\n"
     << "\n";
 
-  ir::Keys keys = snapshot.keys;
-  std::sort(std::begin(keys), std::end(keys));
+  const auto keys = sorted(snapshot.keys);
 
   p << tab(1) << "//print each configuration key" << "\n";
 
-  for (const auto & key : keys) {
+  for (const ir::Key & key : keys) {
     this->key(p, key);
   }
 
-  p << tab(1) << "std::string & keys(const char * *, const int, std::string &);" << "\n"
-    << tab(1) << "std::string & all(std::string &);" << "\n"
+  p << tab(1) << "JsonBuffer & keys(const char * *, const int, JsonBuffer &);" << "\n"
+    << tab(1) << "JsonBuffer & all(JsonBuffer &);" << "\n"
     << "};" << "\n"
     << "\n";
 }
 
 void CPPJsonHeaderGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
   header(p, snapshot.namespaces);
+  buffer(p);
   configurationClass(p, snapshot);
   footer(p, snapshot.namespaces);
 }
@@ -47,6 +93,10 @@ void CPPJsonHeaderGenerator::header(Printer & p, const ir::Namespaces & n) {
   p << "#ifndef CONFIGURATION_JSON_H" << "\n"
     << "#define CONFIGURATION_JSON_H" << "\n"
     << "\n"
+    << "#include <algorithm>" << "\n"
+    << "#include <cstdlib>" << "\n"
+    << "#include <cstring>" << "\n"
+    << "#include <new>" << "\n"
     << "#include <string>" << "\n"
     << "\n"
     << "#include \"configuration.h\"" << "\n"
@@ -67,8 +117,13 @@ void CPPJsonHeaderGenerator::footer(Printer & p, const ir::Namespaces & n) {
 
   p << "\n"
     << "extern \"C\" {" << "\n"
+    << "//*o is NULL if rendering failed, the caller frees it otherwise" << "\n"
     << "void json(const char * *, const int, const char * *," << "\n"
     << tab(4) << "const int, char * *, int *);" << "\n"
+    << "//appends nothing if rendering failed" << "\n"
+    << "void jsonAppend(const char * *, const int, const char * *," << "\n"
+    << tab(4) << "const int, char * *, size_t *, size_t *);" << "\n"
+    << "int context(const char * *, const int, uint32_t *, const int);" << "\n"
     << "int version(void);" << "\n"
     << "}" << "\n"
     << "\n"
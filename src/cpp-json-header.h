@@ -25,6 +25,8 @@ struct CPPJsonHeaderGenerator : public Generator {
 
   void contextClass(Printer &, const ir::Snapshot &);
 
+  void buffer(Printer &);
+
   void configurationClass(Printer &, const ir::Snapshot &);
 
   void generate(Printer &, const ir::Snapshot &);
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <algorithm>
+
+#include "cpp-layout.h"
+
+namespace cpp {
+  size_t alignment(const ir::Structure::Property & p,
+      const ir::Structures & s) {
+    //containers and strings hold pointers
+    if (p.kind != ir::kNone || p.type == "string") {
+      return 8;
+    }
+
+    if (p.type == "boolean" || p.width == "int8") {
+      return 1;
+    } else if (p.width == "int16") {
+      return 2;
+    } else if (p.width == "int32" || p.width == "float") {
+      return 4;
+    } else if (p.type == "integer" || p.type == "float") {
+      return 8;
+    }
+
+    for (const auto & structure : s) {
+      if (structure.identifier == p.type
+          || std::find(std::begin(structure.aliases),
+            std::end(structure.aliases), p.type) != std::end(structure.aliases)) {
+        size_t result = 1;
+        for (const auto & property : structure.properties) {
+          result = std::max(result, alignment(property, s));
+        }
+        return result;
+      }
+    }
+
+    return 8;
+  }
+
+  Sorted< ir::Structure::Property > layout(const ir::Structure & structure,
+      const ir::Structures & s) {
+    auto result = sorted(structure.properties);
+    std::stable_sort(std::begin(result), std::end(result),
+        [&](const ir::Structure::Property & a,
+            const ir::Structure::Property & b) {
+          return alignment(a, s) > alignment(b, s);
+        });
+    return result;
+  }
+} //end of cpp namespace
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef CPP_LAYOUT_H
+#define CPP_LAYOUT_H
+
+#include <cstddef>
+
+#include "generator.h"
+#include "ir.h"
+
+namespace cpp {
+  //alignment of the member generated for a property on LP64 targets
+  size_t alignment(const ir::Structure::Property &, const ir::Structures &);
+
+  /*
+   * members in declaration order: decreasing alignment, then by name. No
+   * padding is needed between members, only at the end of the structure.
+   * Header and code generators have to agree on it.
+   */
+  Sorted< ir::Structure::Property > layout(const ir::Structure &,
+      const ir::Structures &);
+} //end of cpp namespace
+
+#endif //CPP_LAYOUT_H
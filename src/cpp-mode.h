@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef CPP_MODE_H
+#define CPP_MODE_H
+
+#include <string>
+
+namespace cpp {
+  /*
+   * how generated Configuration accessors compute their values. Code and
+   * header generators have to agree on it.
+   */
+  enum Mode {
+    kSwitch, //nested switch statements, returns by value
+    kTable, //precomputed values indexed by context, returns by reference
+    kCache, //nested switch statements run once per Configuration instance
+    kStatic, //precomputed values selected by switch, returns by reference
+  };
+
+  struct Options {
+    Mode mode;
+
+    //arrays and dynamic keys are views of static storage instead of
+    //std::vector and std::map, values have to be precomputed
+    bool flat;
+
+    //strings are std::string_view into a single pool, output needs C++17
+    bool view;
+
+    Options(const Mode m = kSwitch, const bool f = false,
+        const bool v = false) :
+      mode(m), flat(f), view(v) { }
+  };
+
+  //C++ type of a numeric width ("int32" is int32_t), d for no width
+  inline std::string width(const std::string & w, const std::string & d) {
+    if (w.empty()) {
+      return d;
+    }
+    return w == "float" || w == "double" ? w : w + "_t";
+  }
+
+  //"const char *" has to become "const char * const"
+  inline std::string constant(const std::string & t) {
+    return ! t.empty() && t[t.size() - 1] == '*' ? t + " const" : "const " + t;
+  }
+} //end of cpp namespace
+
+#endif //CPP_MODE_H
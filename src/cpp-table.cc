@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <algorithm>
+#include <assert.h>
+#include <sstream>
+
+#include "cpp-table.h"
+
+namespace {
+//removes one level of indentation from every line of s
+std::string outdent(const std::string & s) {
+  std::string result;
+  result.reserve(s.size());
+  size_t begin = 0;
+  while (begin < s.size()) {
+    size_t end = s.find('\n', begin);
+    end = end == std::string::npos ? s.size() : end + 1;
+    const size_t skip = s.compare(begin, 2, "  ") == 0 ? 2 : 0;
+    result.append(s, begin + skip, end - begin - skip);
+    begin = end;
+  }
+  return result;
+}
+
+struct Select {
+  Generator & g;
+  const Resolver::Table & table;
+  const std::vector< size_t > & pools;
+  const ir::Dimensions & dimensions;
+  const std::string & c;
+  const std::function< std::string (const size_t) > & leaf;
+
+  //same traversal as Resolver::Table
+  std::vector< const ir::Dimension * > pending;
+  Resolver::Table::Path path;
+
+  std::string finish(const int t) {
+    if (pending.empty()) {
+      std::stringstream ss;
+      Printer p(ss);
+      p << tab(t) << leaf(pools[table.leaf(path)]) << "\n";
+      return ss.str();
+    }
+
+    const ir::Dimension * const d = pending.back();
+    pending.pop_back();
+    const std::string result = walk(*d, t);
+    pending.push_back(d);
+    return result;
+  }
+
+  std::string walk(const ir::Dimension & d, const int t) {
+    if (d.skip || d.values.empty()) {
+      if (static_cast< bool >(d.next)) {
+        pending.push_back(d.next.get());
+      }
+
+      const std::string result = ! d.values.empty()
+        && static_cast< bool >(d.values.front().dimension) ?
+        walk(*d.values.front().dimension, t) : finish(t);
+
+      if (static_cast< bool >(d.next)) {
+        pending.pop_back();
+      }
+      return result;
+    }
+
+    const size_t size = d.values.size();
+    std::vector< std::string > bodies;
+    bodies.reserve(size + 1);
+
+    for (size_t i = 0; i <= size; ++i) {
+      path.emplace_back(&d, i);
+      if (i < size && static_cast< bool >(d.values[i].dimension)) {
+        bodies.push_back(walk(*d.values[i].dimension, t + 1));
+      } else if (i == size && static_cast< bool >(d.next)) {
+        bodies.push_back(walk(*d.next, t + 1));
+      } else {
+        bodies.push_back(finish(t + 1));
+      }
+      path.pop_back();
+    }
+
+    const std::string & none = bodies.back();
+
+    if (std::all_of(std::begin(bodies), std::end(bodies),
+          [&](const std::string & b) { return b == none; })) {
+      return outdent(none);
+    }
+
+    const auto iterator = dimensions.find(d.dimension);
+    assert(iterator != dimensions.end());
+    const auto & values = iterator->second.values;
+
+    std::stringstream ss;
+    Printer p(ss);
+
+    p << tab(t) << "switch (" << c << "." << g.identifier(d.dimension) << ") {" << "\n";
+
+    std::vector< bool > done(size, false);
+
+    for (size_t i = 0; i < size; ++i) {
+      if (done[i] || bodies[i] == none) {
+        continue;
+      }
+
+      for (size_t j = i; j < size; ++j) {
+        if ( ! done[j] && bodies[j] == bodies[i]) {
+          done[j] = true;
+          assert(values.size() > d.values[j].index);
+          p << tab(t) << "case " << g.constantify(d.dimension) << "::"
+            << g.constantify(values[d.values[j].index].first) << ":" << "\n";
+        }
+      }
+
+      p << bodies[i];
+    }
+
+    p << tab(t) << "default:" << "\n"
+      << none
+      << tab(t) << "}" << "\n";
+
+    return ss.str();
+  }
+};
+} //end of anonymous namespace
+
+namespace cpp {
+  const char * unsignedType(const size_t max) {
+    if (max <= 0xff) {
+      return "uint8_t";
+    } else if (max <= 0xffff) {
+      return "uint16_t";
+    }
+    return "uint32_t";
+  }
+
+  std::string maps(Printer & p, Generator & g, const Resolver::Table & t,
+      const ir::Dimensions & dimensions, const std::string & c) {
+    std::string offset;
+    size_t stride = t.size;
+
+    for (const auto & item : t.switches) {
+      const auto iterator = dimensions.find(item.first);
+      assert(iterator != dimensions.end());
+      const std::string name = g.constantify(item.first) + "_MAP";
+
+      std::vector< size_t > map(iterator->second.values.size(), 0);
+      for (size_t i = 0; i < item.second.size(); ++i) {
+        assert(item.second[i] < map.size());
+        map[item.second[i]] = i + 1;
+      }
+
+      p << tab(1) << "static const " << unsignedType(item.second.size())
+        << " " << name << "[] = {";
+      array(p, map, 2);
+      p << tab(1) << "};" << "\n";
+
+      stride /= item.second.size() + 1;
+
+      if ( ! offset.empty()) {
+        offset += " + ";
+      }
+
+      offset += name + "[" + c + "." + g.identifier(item.first) + "]";
+
+      if (stride > 1) {
+        offset += " * " + std::to_string(stride);
+      }
+    }
+
+    return offset;
+  }
+
+  void select(Printer & p, Generator & g, const ir::Key & k,
+      const Resolver::Table & table, const std::vector< size_t > & pools,
+      const ir::Dimensions & dimensions, const std::string & c,
+      const std::function< std::string (const size_t) > & leaf, const int t) {
+    assert(pools.size() == table.leaves.size());
+    Select select{g, table, pools, dimensions, c, leaf, {}, {}};
+    p << (static_cast< bool >(k.dimension) ? select.walk(*k.dimension, t)
+        : select.finish(t));
+  }
+} //end of cpp namespace
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef CPP_TABLE_H
+#define CPP_TABLE_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "generator.h"
+#include "ir.h"
+#include "resolver.h"
+
+namespace cpp {
+  //smallest unsigned type holding max
+  const char * unsignedType(const size_t max);
+
+  //prints v as the body of an array initializer, 16 items per line
+  template < class T >
+  void array(Printer & p, const std::vector< T > & v, const int t) {
+    for (size_t i = 0; i < v.size(); ++i) {
+      p << (i % 16 == 0 ? "\n" : " ");
+      if (i % 16 == 0) {
+        p << tab(t);
+      }
+      p << v[i] << ",";
+    }
+    p << "\n";
+  }
+
+  /*
+   * prints one static X_MAP array per dimension the table switches on,
+   * remapping the context's value to its position in the table (values
+   * the key does not mention map to 0, NONE). Returns the expression
+   * computing the table offset out of "c", the context.
+   */
+  std::string maps(Printer &, Generator &, const Resolver::Table &,
+      const ir::Dimensions &, const std::string & c);
+
+  /*
+   * prints nested switches following the key's dimension tree, at its
+   * leaves the statement leaf(p) for the pool entry p holds the leaf's
+   * value, pools[i] being the entry of the table's i-th leaf. Branches
+   * printing the same thing share their case labels, those printing what
+   * default does are left out. leaf has to return.
+   */
+  void select(Printer &, Generator &, const ir::Key &, const Resolver::Table &,
+      const std::vector< size_t > & pools, const ir::Dimensions &,
+      const std::string & c,
+      const std::function< std::string (const size_t) > & leaf, const int t);
+} //end of cpp namespace
+
+#endif //CPP_TABLE_H
@@ -17,10 +17,9 @@ void DartGenerator::structure (Printer & p, const ir::Structure & structure) {
   {
     bool requiresConstructor = false;
 
-    ir::Structure::Properties properties = structure.properties;
-    std::sort(std::begin(properties), std::end(properties));
+    const auto properties = sorted(structure.properties);
 
-    for (const auto & property : properties) {
+    for (const ir::Structure::Property & property : properties) {
       p << tab(1) << type(property.type, property.kind) << " "
         << identifier(property.property) << ";" << "\n";
 
@@ -31,7 +30,7 @@ void DartGenerator::structure (Printer & p, const ir::Structure & structure) {
       p << "\n"
         << tab(1) << id << "() :" << "\n";
       bool first = true;
-      for (const auto & property : properties) {
+      for (const ir::Structure::Property & property : properties) {
           if (constructor(property)) {
             if (first) {
               first = false;
@@ -50,35 +49,24 @@ void DartGenerator::structure (Printer & p, const ir::Structure & structure) {
   }
 }
 
-void DartGenerator::content(Printer & p, const Type::TYPES t,
-    const std::string & c) {
+void DartGenerator::content(Printer & p, const Value & v) {
 
-  switch (t) {
-  case Type::kBoolean: {
-    using namespace std;
-
-    string content;
-
-    transform(begin(c), end(c),
-        back_inserter(content), ::tolower);
-
-    assert(content == "true" || content == "false");
-
-    p << content;
+  switch (v.type) {
+  case Type::kBoolean:
+    p << (v.scalar.boolean ? "true" : "false");
     break;
-  }
 
   case Type::kFloat:
   case Type::kInteger:
-    p << c;
+    p << v.content;
     break;
 
   case Type::kObject:
-    p << "new " << c << "()";
+    p << "new " << v.content << "()";
     break;
 
   case Type::kString:
-    p << '"' << c << '"'; break;
+    p << '"' << v.content << '"'; break;
 
   case Type::kUndefined:
     //std::cerr << "type is undefined" << std::endl;
@@ -96,7 +84,7 @@ void DartGenerator::value(Printer & p, const Value & value,
     if (value.type == Type::kArray) {
       for (const auto & item : value.properties) {
         p << tab(t) << prefix << ".add(";
-        content(p, item.second.type, item.second.content);
+        content(p, item.second);
         p << ");" << "\n";
       }
     } else if (value.type == Type::kObject) {
@@ -124,7 +112,7 @@ void DartGenerator::value(Printer & p, const Value & value,
   } else if (value.type != Type::kUndefined) {
     assert( ! value.content.empty() || value.type == Type::kString);
     p << tab(t) << prefix << " = ";
-    content(p, value.type, value.content);
+    content(p, value);
     p << ";" << "\n";
   }
 }
@@ -246,13 +234,12 @@ void DartGenerator::configurationClass(Printer & p, const ir::Snapshot & snapsho
     << "\n";
 
   {
-    ir::Keys keys = snapshot.keys;
-    std::sort(std::begin(keys), std::end(keys));
+    const auto keys = sorted(snapshot.keys);
 
     p << tab(1) << "//print each configuration key" << "\n";
 
     bool first = true;
-    for (const auto & key : keys) {
+    for (const ir::Key & key : keys) {
       if (first) {
         first = false;
       } else {
@@ -270,12 +257,11 @@ void DartGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dime
 
   const std::string enumerationName = constantify(dimension.dimension);
 
-  ir::DimensionEnumeration::Values values = dimension.values;
-  std::sort(std::begin(values), std::end(values));
+  const auto values = sorted(dimension.values);
 
   p << "enum " << enumerationName << " {" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(1) << constantify(value.first) << "," << "\n";
   }
 
@@ -287,7 +273,7 @@ void DartGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dime
     << tab(1) << "//print look-up table" << "\n"
     << tab(1) << "static $table = array(" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(2) << "'" << value.first << "' => " << className << "::" << constantify(value.first) << "," << "\n";
   }
 
@@ -301,7 +287,7 @@ void DartGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
   header(p, snapshot.namespaces);
 
   {
-    ir::Structures structures = snapshot.structures;
+    const ir::Structures & structures = snapshot.structures;
 
     for (const auto & item : structures) {
       structure(p, item);
@@ -16,7 +16,7 @@ struct DartGenerator : public Generator {
 
   void structure(Printer &, const ir::Structure &);
 
-  void content(Printer &, const Type::TYPES, const std::string &);
+  void content(Printer &, const Value &);
 
   void dimension(Printer &, const ir::DimensionEnumeration &);
   void dimensionClass(Printer &);
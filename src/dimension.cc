@@ -48,17 +48,17 @@ Context DimensionTable::context(const DimensionTable::Input & i) {
     dimensions[entry.did] = entry.values.insert(item.second).vid;
   }
 
-  return Context(std::move(dimensions));
+  return Context(dimensions);
 }
 
 //TODO(dmorilha): the index subscriptor alters the object
 //preventing this function to be const.
 DimensionTable::Input DimensionTable::lookup(const Context & c) {
   DimensionTable::Input input;
-  for (size_t i = 0; i < c.dimensions.size(); ++i) {
+  for (int i = 0; i < c.size(); ++i) {
     input.push_back(std::make_pair(
           index[i]->dimension,
-          index[i]->values.index[c.dimensions[i]]->value));
+          index[i]->values.index[c[i]]->value));
   }
   return input;
 }
@@ -70,6 +70,13 @@ DimensionTable::Entry & DimensionTable::operator [] (const size_t i) {
   return *result;
 }
 
+const DimensionTable::Entry & DimensionTable::operator [] (const size_t i) const {
+  const auto iterator = index.find(i);
+  assert(iterator != index.end());
+  assert(iterator->second != nullptr);
+  return *iterator->second;
+}
+
 DimensionTable::Entry * DimensionTable::operator [] (const std::string & n) {
   DimensionTable::Entry * result = nullptr;
   const auto iterator = entries.find(n);
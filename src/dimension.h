@@ -87,6 +87,7 @@ struct DimensionTable {
   DimensionTable(void) : did(0) { }
 
   Entry & operator [] (const size_t);
+  const Entry & operator [] (const size_t) const;
   Entry * operator [] (const std::string &);
   const Entry * operator [] (const std::string &) const;
 
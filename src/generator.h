@@ -7,9 +7,13 @@
 #ifndef GENERATOR_H
 #define GENERATOR_H
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include "ir.h"
 
@@ -34,6 +38,32 @@ struct Printer {
   Printer & operator << (const tab &);
 };
 
+template < class T >
+using Sorted = std::vector< std::reference_wrapper< const T > >;
+
+/*
+ * the elements in [b, e) in operator < order. Only references get sorted,
+ * generators share the snapshot without copying it.
+ */
+template < class I >
+Sorted< typename std::iterator_traits< I >::value_type > sorted(I b,
+    const I e) {
+  typedef typename std::iterator_traits< I >::value_type T;
+  Sorted< T > result;
+  result.reserve(std::distance(b, e));
+  for (; b != e; ++b) {
+    result.push_back(std::cref(*b));
+  }
+  std::sort(std::begin(result), std::end(result),
+      [](const T & a, const T & b) { return a < b; });
+  return result;
+}
+
+template < class C >
+Sorted< typename C::value_type > sorted(const C & c) {
+  return sorted(std::begin(c), std::end(c));
+}
+
 struct Generator {
   typedef std::unique_ptr< Generator > Pointer;
 
@@ -12,13 +12,13 @@ struct GraphBuilderVisitor : boost::default_dfs_visitor {
   typedef std::vector< ir::DimensionPointer * > Stack;
 
   ir::Key & key_;
-  dimensions::DimensionTable & table_;
+  const dimensions::DimensionTable & table_;
   int degree_;
   const Context * last_;
   ir::DimensionPointer * current_;
   Stack stack_;
 
-  GraphBuilderVisitor(ir::Key & k, dimensions::DimensionTable & d) :
+  GraphBuilderVisitor(ir::Key & k, const dimensions::DimensionTable & d) :
     key_(k), table_(d), degree_(0),
     last_(nullptr), current_(nullptr) { }
 
@@ -76,7 +76,7 @@ struct GraphBuilderVisitor : boost::default_dfs_visitor {
 };
 
 ir::Key GraphBuilder::build(const std::string & s,
-    Graph & g, dimensions::DimensionTable & d) {
+    Graph & g, const dimensions::DimensionTable & d) {
   ir::Key key(s);
   GraphBuilderVisitor visitor(key, d);
   boost::depth_first_search(g, boost::visitor(visitor));
@@ -11,6 +11,7 @@
 #include "ir.h"
 
 struct GraphBuilder {
-  ir::Key build(const std::string &, Graph &, dimensions::DimensionTable &);
+  ir::Key build(const std::string &, Graph &,
+      const dimensions::DimensionTable &);
 };
 #endif //GRAPH_BUILDER_H
@@ -4,16 +4,68 @@
  * See the accompanying LICENSE file for terms.
  */
 
+#include <algorithm>
 #include <iostream>
+#include <unordered_map>
 
 #include <boost/graph/depth_first_search.hpp>
 
 #include "graph-type-propagator.h"
 
+/*
+ * a value's properties ordered by name, properties sharing a name keep
+ * their relative order.
+ */
+struct PropertyIndex {
+  typedef std::pair< Symbol, const Value * > Entry;
+  typedef std::vector< Entry > Entries;
+  typedef std::pair< Entries::const_iterator, Entries::const_iterator > Range;
+
+  Entries entries;
+
+  explicit PropertyIndex(const Value & v) {
+    entries.reserve(v.properties.size());
+    for (const auto & item : v.properties) {
+      entries.emplace_back(item.first, &item.second);
+    }
+    std::stable_sort(std::begin(entries), std::end(entries), compare);
+  }
+
+  Range find(const Symbol & n) const {
+    return std::equal_range(std::begin(entries), std::end(entries),
+        Entry(n, nullptr), compare);
+  }
+
+  static bool compare(const Entry & a, const Entry & b) {
+    return a.first < b.first;
+  }
+};
+
 struct GraphTypePropagatorVisitor : boost::default_dfs_visitor {
   typedef std::vector< const Value * > Stack;
+  typedef std::vector< const PropertyIndex * > Indexes;
   Stack stack_;
 
+  /*
+   * the same ancestors show up in the stack of every value below them,
+   * each one is indexed once. Property lists do not change here.
+   */
+  std::unordered_map< const Value *, PropertyIndex > indexes_;
+
+  Indexes index(const Stack & s) {
+    Indexes indexes;
+    indexes.reserve(s.size());
+    for (const auto & j : s) {
+      assert(j != nullptr);
+      auto item = indexes_.find(j);
+      if (item == std::end(indexes_)) {
+        item = indexes_.emplace(j, PropertyIndex(*j)).first;
+      }
+      indexes.push_back(&item->second);
+    }
+    return indexes;
+  }
+
   GraphTypePropagatorVisitor(void) { }
 
   void discover_vertex(Graph::vertex_descriptor v, const Graph & g) {
@@ -63,24 +115,21 @@ struct GraphTypePropagatorVisitor : boost::default_dfs_visitor {
         {
           assert( ! first.properties.empty());
           const auto & first2 = first.properties.front();
-          //TODO(dmorilha): everything would be so much better if they were all sorted
           for (const auto & i : v.properties) {
             assert(i.first != "");
             assert(i.second.type == first2.second.type);
           }
 
           if (first2.second.type == Type::kObject) {
+            const Indexes indexes = m ? index(s) : Indexes();
+
             for (const auto & i : v.properties) {
               Stack stack;
 
-              if (m) {
-                for (const auto & j : s) {
-                  assert(j != nullptr);
-                  for (const auto & k : j->properties) {
-                    if (i.first == k.first) {
-                      stack.push_back(&k.second);
-                    }
-                  }
+              for (const auto & j : indexes) {
+                const auto range = j->find(i.first);
+                for (auto k = range.first; k != range.second; ++k) {
+                  stack.push_back(k->second);
                 }
               }
 
@@ -101,17 +150,15 @@ struct GraphTypePropagatorVisitor : boost::default_dfs_visitor {
       case Type::kObject:
         {
           assert( ! first.properties.empty());
-          //TODO(dmorilha): everything would be so much better if they were all sorted
+          const Indexes indexes = index(s);
+
           for (const auto & i : v.properties) {
             assert(i.first != "");
             Stack stack;
-            for (const auto & j : s) {
-              assert(j != nullptr);
-              for (const auto & k : j->properties) {
-                if (i.first == k.first) {
-                  stack.push_back(&k.second);
-                  break;
-                }
+            for (const auto & j : indexes) {
+              const auto range = j->find(i.first);
+              if (range.first != range.second) {
+                stack.push_back(range.first->second);
               }
             }
             if ( ! stack.empty()) {
@@ -125,7 +172,7 @@ struct GraphTypePropagatorVisitor : boost::default_dfs_visitor {
       case Type::kInteger:
       case Type::kFloat:
         if (static_cast< bool >(first.regex)) {
-          if ( ! std::regex_match(v.content, *first.regex)) {
+          if ( ! std::regex_match(v.content.str(), *first.regex)) {
             std::cerr << "value \"" << v.content << "\" did not pass regular expression test" << std::endl;
             assert(false);
           }
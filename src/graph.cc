@@ -4,58 +4,82 @@
  * See the accompanying LICENSE file for terms.
  */
 
+#include <algorithm>
+#include <iterator>
 #include <vector>
 
 #include "graph.h"
 
-struct EdgeSorter {
-  const Graph & graph_;
-  EdgeSorter(const Graph & g) : graph_(g) { }
+typedef std::pair< Context, Graph::vertex_descriptor > Entry;
+typedef std::vector< Entry > Entries;
 
-  bool operator () (const Graph::edge_descriptor & a,
-      const Graph::edge_descriptor & b) const {
-    return graph_[a] < graph_[b];
+struct EntrySorter {
+  bool operator () (const Entry & a, const Entry & b) const {
+    return a.first < b.first;
+  }
+
+  bool operator () (const Entry & a, const Context & b) const {
+    return a.first < b;
+  }
+
+  bool operator () (const Context & a, const Entry & b) const {
+    return a < b.first;
   }
 };
 
+/*
+ * every context a can only be contained by its own truncations (first n
+ * dimensions followed by NONE), which sort before it. Once all the edges are
+ * sorted, the nearest ancestor is the longest truncation found by binary
+ * searching the entries that precede it. The all NONE truncation is a
+ * candidate as well, root is the parent only when none is found. Repeated
+ * contexts chain, so the parent is the last copy of the truncation.
+ */
 void contextSort(Graph & g) {
-  typedef std::pair< Graph::edge_iterator, Graph::edge_iterator > Pair;
-  Pair p = boost::edges(g);
-  std::vector< Graph::edge_descriptor > edges(p.first, p.second);
-  std::sort(std::begin(edges), std::end(edges), EdgeSorter(g));
-
-  const size_t size = edges.size();
-
-  for (size_t i = 0; i < size; ++i) {
-    const Graph::edge_descriptor a = edges[i];
-    for (size_t j = i + 1; j < size; ++j) {
-      const Graph::edge_descriptor b = edges[j];
-      const Context r = g[b];
-      if (g[a].contains(g[b])) {
-        edges.push_back(add_edge(target(a, g), target(b, g), r, g).first);
-      } else {
-        edges.push_back(add_edge(*vertices(g).first, target(b, g), r, g).first);
-      }
+  const Graph::vertex_descriptor root = *vertices(g).first;
+
+  Entries entries;
+
+  {
+    const auto p = out_edges(root, g);
+    for (auto iterator = p.first; iterator != p.second; ++iterator) {
+      entries.emplace_back(std::move(g[*iterator]), target(*iterator, g));
     }
   }
 
-  reverse(std::begin(edges), std::end(edges));
-
-  size_t newSize = edges.size();
-  size_t additionalSize = newSize - size;
-
-  for (size_t i = 0; i < additionalSize; ++i) {
-    const Graph::edge_descriptor a = edges[i];
-    for (size_t j = i + 1; j < newSize; ++j) {
-      const Graph::edge_descriptor b = edges[j];
-      if (target(a, g) == target(b, g)) {
-        remove_edge(b, g);
-        edges.erase(std::begin(edges) + j);
-        --newSize;
-        if (j < additionalSize) {
-          --additionalSize;
+  clear_out_edges(root, g);
+
+  std::sort(std::begin(entries), std::end(entries), EntrySorter());
+
+  const auto begin = std::begin(entries);
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const Context & c = entries[i].first;
+    Graph::vertex_descriptor parent = root;
+
+    if (i > 0 && entries[i - 1].first == c) {
+      parent = entries[i - 1].second;
+
+    } else {
+      Context truncation = c;
+
+      for (int d = c.degree() - 1; d >= 0; --d) {
+        if (truncation[d] == 0) {
+          continue;
+        }
+
+        truncation.clear(d);
+
+        const auto iterator = std::upper_bound(begin, begin + i,
+            truncation, EntrySorter());
+
+        if (iterator != begin && std::prev(iterator)->first == truncation) {
+          parent = std::prev(iterator)->second;
+          break;
         }
       }
     }
+
+    add_edge(parent, entries[i].second, c, g);
   }
 }
@@ -36,7 +36,8 @@ ir::Key::Key(const ir::Key & k) :
   type(k.type),
   cache(k.cache),
   kind(k.kind),
-  alias(k.alias) {
+  alias(k.alias),
+  width(k.width) {
 
   if (static_cast< bool >(k.dimension)) {
     dimension.reset(new ir::Dimension(*k.dimension));
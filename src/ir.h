@@ -57,6 +57,7 @@ namespace ir {
       dimension(nullptr) { }
 
     DimensionValue(const DimensionValue &);
+    DimensionValue(DimensionValue &&) = default;
   };
 
   typedef std::vector< DimensionValue > DimensionValues;
@@ -101,6 +102,7 @@ namespace ir {
     bool cache;
     Kind kind;
     std::string alias;
+    std::string width; //"int32", "float"... empty for the type's default
 
     template < class T1, class T2, class T3 >
     Key(T1 && k, T2 && v, T3 && t, DimensionPointer && d) :
@@ -122,6 +124,7 @@ namespace ir {
       kind(kNone) { }
 
     Key(const Key &);
+    Key(Key &&) = default;
 
     Key & operator = (Key &&) = default;
     bool operator < (const Key &) const;
@@ -138,6 +141,7 @@ namespace ir {
       std::string property;
       std::string type;
       Kind kind;
+      std::string width; //same as Key::width
 
       struct {
         std::string declaration;
@@ -17,10 +17,9 @@ void JavaGenerator::structure (Printer & p, const ir::Structure & structure) {
   {
     bool requiresConstructor = false;
 
-    ir::Structure::Properties properties = structure.properties;
-    std::sort(std::begin(properties), std::end(properties));
+    const auto properties = sorted(structure.properties);
 
-    for (const auto & property : properties) {
+    for (const ir::Structure::Property & property : properties) {
       p << tab(1) << "public " << type(property.type, property.kind) << " "
         << identifier(property.property) << ";" << "\n";
 
@@ -30,7 +29,7 @@ void JavaGenerator::structure (Printer & p, const ir::Structure & structure) {
     if (requiresConstructor) {
       p << "\n"
         << tab(1) << id << "() {" << "\n";
-      for (const auto & property : properties) {
+      for (const ir::Structure::Property & property : properties) {
           if (constructor(property)) {
             p << tab(2) << identifier(property.property) << " = new "
               << type(property.type, property.kind) << "();" << "\n";
@@ -44,35 +43,24 @@ void JavaGenerator::structure (Printer & p, const ir::Structure & structure) {
   }
 }
 
-void JavaGenerator::content(Printer & p, const Type::TYPES t,
-    const std::string & c) {
+void JavaGenerator::content(Printer & p, const Value & v) {
 
-  switch (t) {
-  case Type::kBoolean: {
-    using namespace std;
-
-    string content;
-
-    transform(begin(c), end(c),
-        back_inserter(content), ::tolower);
-
-    assert(content == "true" || content == "false");
-
-    p << content;
+  switch (v.type) {
+  case Type::kBoolean:
+    p << (v.scalar.boolean ? "true" : "false");
     break;
-  }
 
   case Type::kFloat:
   case Type::kInteger:
-    p << c;
+    p << v.content;
     break;
 
   case Type::kObject:
-    p << "new " << c << "()";
+    p << "new " << v.content << "()";
     break;
 
   case Type::kString:
-    p << '"' << c << '"'; break;
+    p << '"' << v.content << '"'; break;
 
   case Type::kUndefined:
     //std::cerr << "type is undefined" << std::endl;
@@ -90,7 +78,7 @@ void JavaGenerator::value(Printer & p, const Value & value,
     if (value.type == Type::kArray) {
       for (const auto & item : value.properties) {
         p << tab(t) << prefix << ".add(";
-        content(p, item.second.type, item.second.content);
+        content(p, item.second);
         p << ");" << "\n";
       }
     } else if (value.type == Type::kObject) {
@@ -116,7 +104,7 @@ void JavaGenerator::value(Printer & p, const Value & value,
 
         } else if ( ! item.second.content.empty()) {
           p << tab(t) << prefix << ".put(\"" << item.first << "\", ";
-          content(p, item.second.type, item.second.content);
+          content(p, item.second);
           p << ");" << "\n";
         }
       }
@@ -126,7 +114,7 @@ void JavaGenerator::value(Printer & p, const Value & value,
   } else if (value.type != Type::kUndefined) {
     assert( ! value.content.empty() || value.type == Type::kString);
     p << tab(t) << prefix << " = ";
-    content(p, value.type, value.content);
+    content(p, value);
     p << ";" << "\n";
   }
 }
@@ -249,13 +237,12 @@ void JavaGenerator::configurationClass(Printer & p, const ir::Snapshot & snapsho
     << "\n";
 
   {
-    ir::Keys keys = snapshot.keys;
-    std::sort(std::begin(keys), std::end(keys));
+    const auto keys = sorted(snapshot.keys);
 
     p << tab(1) << "//print each configuration key" << "\n";
 
     bool first = true;
-    for (const auto & key : keys) {
+    for (const ir::Key & key : keys) {
       if (first) {
         first = false;
       } else {
@@ -272,14 +259,13 @@ void JavaGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dime
 
   const std::string enumerationName = constantify(dimension.dimension);
 
-  ir::DimensionEnumeration::Values values = dimension.values;
-  std::sort(std::begin(values), std::end(values));
+  const auto values = sorted(dimension.values);
 
   p << "enum " << enumerationName << " {" << "\n";
 
   if ( ! values.empty()) {
     bool first = true;
-    for (const auto & value : values) {
+    for (const ir::DimensionEnumeration::Value & value : values) {
       if (first) {
         first = false;
       } else {
@@ -302,7 +288,7 @@ void JavaGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dime
     << tab(1) << "//print look-up table" << "\n"
     << tab(1) << "static $table = array(" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(2) << "'" << value.first << "' => " << className << "::" << constantify(value.first) << "," << "\n";
   }
 
@@ -316,7 +302,7 @@ void JavaGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
   header(p, snapshot.namespaces);
 
   {
-    ir::Structures structures = snapshot.structures;
+    const ir::Structures & structures = snapshot.structures;
 
     for (const auto & item : structures) {
       structure(p, item);
@@ -17,7 +17,7 @@ struct JavaGenerator : public Generator {
 
   void structure(Printer &, const ir::Structure &);
 
-  void content(Printer &, const Type::TYPES, const std::string &);
+  void content(Printer &, const Value &);
 
   void dimension(Printer &, const ir::DimensionEnumeration &);
   void dimensionClass(Printer &);
@@ -16,10 +16,9 @@ void JSGenerator::structure (Printer & p, const ir::Structure & structure) {
   p << tab(1) << "function " << id << "() {" << "\n";
 
   {
-    ir::Structure::Properties properties = structure.properties;
-    std::sort(std::begin(properties), std::end(properties));
+    const auto properties = sorted(structure.properties);
 
-    for (const auto & property : properties) {
+    for (const ir::Structure::Property & property : properties) {
       p << tab(2) << "this." << identifier(property.property) << " = ";
 
       if (property.kind == ir::kArray) {
@@ -71,35 +70,24 @@ void JSGenerator::structure (Printer & p, const ir::Structure & structure) {
   }
 }
 
-void JSGenerator::content(Printer & p, const Type::TYPES t,
-    const std::string & c) {
+void JSGenerator::content(Printer & p, const Value & v) {
 
-  switch (t) {
-  case Type::kBoolean: {
-    using namespace std;
-
-    string content;
-
-    transform(begin(c), end(c),
-        back_inserter(content), ::tolower);
-
-    assert(content == "true" || content == "false");
-
-    p << content;
+  switch (v.type) {
+  case Type::kBoolean:
+    p << (v.scalar.boolean ? "true" : "false");
     break;
-  }
 
   case Type::kFloat:
   case Type::kInteger:
-    p << c;
+    p << v.content;
     break;
 
   case Type::kObject:
-    p << "new " << c << "()";
+    p << "new " << v.content << "()";
     break;
 
   case Type::kString:
-    p << "\"" << c << "\"";
+    p << "\"" << v.content << "\"";
     break;
 
   case Type::kUndefined:
@@ -122,7 +110,7 @@ void JSGenerator::value(Printer & p, const Value & value,
           continue;
         }
         p << tab(t) << prefix << ".push(";
-        content(p, item.second.type, item.second.content);
+        content(p, item.second);
         p << ");" << "\n";
       }
     } else if (value.type == Type::kObject) {
@@ -154,7 +142,7 @@ void JSGenerator::value(Printer & p, const Value & value,
     assert( ! value.content.empty() || value.type == Type::kString);
     assert( ! value.ignore);
     p << tab(t) << prefix << " = ";
-    content(p, value.type, value.content);
+    content(p, value);
     p << ";" << "\n";
   }
 }
@@ -260,13 +248,12 @@ void JSGenerator::configurationClass(Printer & p, const ir::Snapshot & snapshot)
     << "\n";
 
   {
-    ir::Keys keys = snapshot.keys;
-    std::sort(std::begin(keys), std::end(keys));
+    const auto keys = sorted(snapshot.keys);
 
     p << tab(1) << "//print each configuration key" << "\n";
     p << tab(1) << "Configuration.prototype = {" << "\n";
 
-    for (const auto & key : keys) {
+    for (const ir::Key & key : keys) {
       this->key(p, key);
     }
   }
@@ -278,13 +265,12 @@ void JSGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dimens
 
   const std::string className = constantify(dimension.dimension);
 
-  ir::DimensionEnumeration::Values values = dimension.values;
-  std::sort(std::begin(values), std::end(values));
+  const auto values = sorted(dimension.values);
 
   p << tab(1) << "//print enumeration" << "\n"
     << tab(1) << "var " << className << " = {" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     const auto constant = constantify(value.first);
 
     if (constant != value.first) {
@@ -303,16 +289,14 @@ void JSGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
   header(p);
 
   {
-    ir::Structures structures = snapshot.structures;
-
-    if ( ! structures.empty()) {
+    if ( ! snapshot.structures.empty()) {
       //php allows declarings classes in any sequence.
-      std::sort(std::begin(structures), std::end(structures));
+      const auto structures = sorted(snapshot.structures);
 
       p << tab(1) << "var ConfigurationStructure = { };" << "\n"
         << "\n";
 
-      for (const auto & item : structures) {
+      for (const ir::Structure & item : structures) {
         structure(p, item);
       }
     }
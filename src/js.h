@@ -27,8 +27,7 @@ struct JSGenerator : public Generator {
 
   void generate(Printer &, const ir::Snapshot &);
 
-  void content(Printer &, const Type::TYPES,
-      const std::string &);
+  void content(Printer &, const Value &);
 
   void value(Printer &, const Value &,
       const std::string &, const int);
@@ -4,13 +4,18 @@
  * See the accompanying LICENSE file for terms.
  */
 
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 
 #include <assert.h>
 
 #include <yaml-cpp/yaml.h>
 
+#include "compile-cache.h"
 #include "graph-builder.h"
 #include "graph-printer.h"
 #include "graph-trimmer.h"
@@ -19,9 +24,12 @@
 #include "graph.h"
 #include "ir.h"
 #include "key.h"
+#include "parallel.h"
 #include "parser.h"
+#include "serializer.h"
 #include "structure-writer.h"
 #include "structure.h"
+#include "width-writer.h"
 #include "yaml.h"
 
 //generators
@@ -47,13 +55,58 @@ bool handleSpecialKeys(KeyTable::Entries::value_type & k) {
   return result;
 }
 
+/*
+ * generators selected with --targets, along with the file each one writes
+ * into --out-dir. File names match the ones in the top level Makefile.
+ */
+struct Target {
+  const char * name;
+  const char * file;
+  Generator * (* create)(const cpp::Options &);
+};
+
+const Target TARGETS[] = {
+  { "cpp-code", "configuration.cc",
+    [](const cpp::Options & o) -> Generator * { return new CPPCodeGenerator(o); } },
+  { "cpp-header", "configuration.h",
+    [](const cpp::Options & o) -> Generator * { return new CPPHeaderGenerator(o); } },
+  { "cpp-json-code", "configuration-json.cc",
+    [](const cpp::Options & o) -> Generator * { return new CPPJsonCodeGenerator(o); } },
+  { "cpp-json-header", "configuration-json.h",
+    [](const cpp::Options &) -> Generator * { return new CPPJsonHeaderGenerator(); } },
+  { "dart", "configuration.dart",
+    [](const cpp::Options &) -> Generator * { return new DartGenerator(); } },
+  { "java", "Configuration.java",
+    [](const cpp::Options &) -> Generator * { return new JavaGenerator(); } },
+  { "js", "configuration.js",
+    [](const cpp::Options &) -> Generator * { return new JSGenerator(); } },
+  { "php", "configuration.php",
+    [](const cpp::Options &) -> Generator * { return new PHPGenerator(); } },
+  { "python", "configuration.py",
+    [](const cpp::Options &) -> Generator * { return new PythonGenerator(); } },
+};
+
+const Target * findTarget(const std::string & n) {
+  for (const auto & target : TARGETS) {
+    if (n == target.name) {
+      return &target;
+    }
+  }
+  return NULL;
+}
+
 int main(int argc, char * * argv) {
 
   bool
+    cppCache = false,
     cppCode = false,
+    cppFlat = false,
     cppHeader = false,
     cppJsonCode = false,
     cppJsonHeader = false,
+    cppStatic = false,
+    cppStringView = false,
+    cppTable = false,
     dart = false,
     graphPrinter = false,
     java = false,
@@ -61,6 +114,15 @@ int main(int argc, char * * argv) {
     php = true,
     python = false;
 
+  int jobs = 1;
+
+  const char
+    * cacheDirectory = NULL,
+    * emitIr = NULL,
+    * fromIr = NULL,
+    * outDirectory = NULL,
+    * targets = NULL;
+
   std::vector< const char * > files;
 
   ir::Snapshot snapshot;
@@ -70,10 +132,15 @@ int main(int argc, char * * argv) {
 
   for (int i = 1; i < argc; ++i) {
     if (*(argv[i]) == '-') {
+      cppCache |= strcmp(argv[i] + 1, "-cpp-cache") == 0;
       cppCode |= strcmp(argv[i] + 1, "-cpp-code") == 0;
+      cppFlat |= strcmp(argv[i] + 1, "-cpp-flat") == 0;
       cppHeader |= strcmp(argv[i] + 1, "-cpp-header") == 0;
       cppJsonCode |= strcmp(argv[i] + 1, "-cpp-json-code") == 0;
       cppJsonHeader |= strcmp(argv[i] + 1, "-cpp-json-header") == 0;
+      cppStatic |= strcmp(argv[i] + 1, "-cpp-static") == 0;
+      cppStringView |= strcmp(argv[i] + 1, "-cpp-string-view") == 0;
+      cppTable |= strcmp(argv[i] + 1, "-cpp-table") == 0;
       dart |= strcmp(argv[i] + 1, "-dart") == 0;
       graphPrinter |= strcmp(argv[i] + 1, "-graph-printer") == 0;
       java |= strcmp(argv[i] + 1, "-java") == 0;
@@ -84,6 +151,30 @@ int main(int argc, char * * argv) {
       if (strcmp(argv[i] + 1, "-set") == 0) {
         ++i;
         assert(i < argc); //--set requires two arguments
+      } else if (strcmp(argv[i] + 1, "-jobs") == 0) {
+        ++i;
+        assert(i < argc); //--jobs requires two arguments
+        jobs = atoi(argv[i]);
+      } else if (strcmp(argv[i] + 1, "-cache") == 0) {
+        ++i;
+        assert(i < argc); //--cache requires two arguments
+        cacheDirectory = argv[i];
+      } else if (strcmp(argv[i] + 1, "-emit-ir") == 0) {
+        ++i;
+        assert(i < argc); //--emit-ir requires two arguments
+        emitIr = argv[i];
+      } else if (strcmp(argv[i] + 1, "-from-ir") == 0) {
+        ++i;
+        assert(i < argc); //--from-ir requires two arguments
+        fromIr = argv[i];
+      } else if (strcmp(argv[i] + 1, "-out-dir") == 0) {
+        ++i;
+        assert(i < argc); //--out-dir requires two arguments
+        outDirectory = argv[i];
+      } else if (strcmp(argv[i] + 1, "-targets") == 0) {
+        ++i;
+        assert(i < argc); //--targets requires two arguments
+        targets = argv[i];
       }
 
     } else {
@@ -91,66 +182,255 @@ int main(int argc, char * * argv) {
     }
   }
 
-  try {
-    using namespace parser;
+  //usage errors are reported before any input gets processed
+  std::vector< const Target * > selected;
 
-    Parser::Result r;
+  if ( ! graphPrinter && outDirectory != NULL) {
+    std::istringstream list(targets != NULL ? targets : "");
+    std::string name;
 
-    for (const auto & file : files) {
-      Parser parser;
-      const auto root = YAML::LoadFile(file);
-      parser.parse(root, r);
+    while (std::getline(list, name, ',')) {
+      const Target * const target = findTarget(name);
+      if (target == NULL) {
+        std::cerr << "unknown target \"" << name << "\"" << std::endl;
+        return 1;
+      }
+      selected.push_back(target);
     }
 
-    snapshot.namespaces = std::move(r.namespaces);
+    if (selected.empty()) {
+      std::cerr << "--out-dir requires --targets, a comma separated list of";
+      for (const auto & target : TARGETS) {
+        std::cerr << (&target == TARGETS ? " " : ", ") << target.name;
+      }
+      std::cerr << std::endl;
+      return 1;
+    }
+  }
+
+  /*
+   * hashes the inputs before the trimmer rewrites the --set arguments.
+   * --graph-printer needs the graphs, which are not part of the snapshot.
+   */
+  std::unique_ptr< CompileCache > cache;
+
+  if (fromIr != NULL) {
+    if ( ! ir::load(fromIr, snapshot)) {
+      std::cerr << "could not load \"" << fromIr << "\"" << std::endl;
+      return 1;
+    }
+  } else if (cacheDirectory != NULL && ! graphPrinter) {
+    cache.reset(new CompileCache(cacheDirectory, files, argv, argc));
+    if ( ! cache->open()) {
+      std::cerr << "could not use \"" << cacheDirectory
+        << "\" as the cache directory" << std::endl;
+      return 1;
+    }
+  }
+
+  if (fromIr == NULL
+      && ( ! static_cast< bool >(cache) || ! cache->load(snapshot))) {
+    try {
+      using namespace parser;
+
+      Parser::Result r;
+
+      /*
+       * loading is where yaml-cpp spends its time and files do not depend on
+       * each other. Parsing into the shared tables stays serial and in file
+       * order, so dimension and value ids match a serial run.
+       */
+      std::vector< YAML::Node > roots(files.size());
 
-    GraphBuilder builder;
+      parallelFor(files.size(), jobs, [&](const size_t i) {
+        roots[i] = YAML::LoadFile(files[i]);
+      });
 
-    GraphTrimmer trimmer = GraphTrimmer::Create(r.dimensions, argv, argc);
-    trimmer.markSkip(r.dimensions);
+      for (const auto & root : roots) {
+        Parser parser;
+        parser.parse(root, r);
+      }
+
+      snapshot.namespaces = std::move(r.namespaces);
+
+      GraphBuilder builder;
+
+      GraphTrimmer trimmer = GraphTrimmer::Create(r.dimensions, argv, argc);
+      trimmer.markSkip(r.dimensions);
 
-    //TODO(dmorilha) we can try this process in parallel...
-    for (auto & item : r.keys.entries) {
-      Key & key = item.second.key;
-      Graph & graph = key.graph;
-      contextSort(graph);
+      typedef std::vector< KeyTable::Entries::value_type * > Items;
+      Items items;
+      items.reserve(r.keys.entries.size());
 
-      trimmer.trim(key.graph);
+      for (auto & item : r.keys.entries) {
+        items.push_back(&item);
+        snapshot.keys.emplace_back(item.first);
+      }
+
+      /*
+       * each key graph is independent from the others, the only shared state
+       * is the structure table, which hands out identifiers in insertion
+       * order. Type extraction stays serial and in key order, so the output
+       * does not depend on the number of jobs.
+       */
+      parallelFor(items.size(), jobs, [&](const size_t i) {
+        Graph & graph = items[i]->second.key.graph;
+        contextSort(graph);
+        trimmer.trim(graph);
+      });
+
+      /*
+       * keys found in the cache replay the structures they added instead of
+       * being extracted, then skip propagation and the builder.
+       */
+      std::vector< uint64_t > hashes;
+      std::vector< ir::Structures > added;
+      std::vector< bool > cached(items.size(), false);
+
+      if (static_cast< bool >(cache)) {
+        cache->dimensions(r.dimensions);
+        hashes.resize(items.size());
+        added.resize(items.size());
+        parallelFor(items.size(), jobs, [&](const size_t i) {
+          hashes[i] = cache->hash(items[i]->first, items[i]->second.key);
+        });
+      }
+
+      Items typed;
+      typed.reserve(items.size());
+      std::vector< bool > extracted(items.size(), false);
+
+      for (size_t i = 0; i < items.size(); ++i) {
+        const auto item = items[i];
+        if (handleSpecialKeys(*item)) {
+          continue;
+        }
+
+        CompileCache::Mark mark;
+        if (static_cast< bool >(cache)) {
+          hashes[i] = cache->hash(hashes[i], structures);
+          cached[i] = cache->load(hashes[i], structures, snapshot.keys[i]);
+          if (cached[i]) {
+            continue;
+          }
+          mark = CompileCache::Mark(structures);
+        }
 
-      if ( ! handleSpecialKeys(item)) {
         GraphTypeExtractor typeExtractor;
-        typeExtractor.extract(key, structures);
+        typeExtractor.extract(item->second.key, structures);
+        typed.push_back(item);
+        extracted[i] = true;
+
+        if (static_cast< bool >(cache)) {
+          added[i] = CompileCache::added(structures, mark);
+        }
+      }
 
+      parallelFor(typed.size(), jobs, [&](const size_t i) {
         GraphTypePropagator propagator;
-        propagator.propagate(key);
+        propagator.propagate(typed[i]->second.key);
+      });
+
+      parallelFor(items.size(), jobs, [&](const size_t i) {
+        if ( ! cached[i]) {
+          snapshot.keys[i] = builder.build(items[i]->first,
+              items[i]->second.key.graph, r.dimensions);
+        }
+      });
+
+      for (size_t i = 0; i < items.size(); ++i) {
+        const auto & item = *items[i];
+        const Key & key = item.second.key;
+
+        if ( ! cached[i]) {
+          ir::Key & irKey = snapshot.keys[i];
+          irKey.kind = key.kind;
+          irKey.type = structures.getTypeName(key.type);
+          irKey.alias = key.alias;
+
+          if (static_cast< bool >(cache) && extracted[i]) {
+            cache->store(hashes[i], added[i], irKey);
+          }
+        }
+
+        if (graphPrinter) {
+          std::cout << "graph for key \"" << item.first << "\"" << std::endl;
+          GraphPrinter printer(std::cout);
+          printer.print(key.graph, r.dimensions);
+          std::cout << std::endl;
+        }
       }
 
-      snapshot.keys.emplace_back(
-        builder.build(item.first, graph, r.dimensions));
+      {
+        StructureWriter writer;
+        writer(structures, snapshot.structures);
+      }
 
       {
-        ir::Key & irKey = snapshot.keys.back();
-        irKey.kind = key.kind;
-        irKey.type = structures.getTypeName(key.type);
-        irKey.alias = key.alias;
+        WidthWriter writer;
+        writer(r.widths, snapshot);
       }
 
-      if (graphPrinter) {
-        std::cout << "graph for key \"" << item.first << "\"" << std::endl;
-        GraphPrinter printer(std::cout);
-        printer.print(graph, r.dimensions);
-        std::cout << std::endl;
+      snapshot.dimensions = r.dimensions.enumerate();
+
+      if (static_cast< bool >(cache)) {
+        cache->store(snapshot);
       }
+
+    } catch (const std::exception & e) {
+      //a partial snapshot must not end up in --emit-ir, --cache or outputs
+      std::cerr << "could not process the input: " << e.what() << std::endl;
+      return 1;
     }
+  }
 
-    {
-      StructureWriter writer;
-      writer(structures, snapshot.structures);
+  if (emitIr != NULL) {
+    std::ofstream stream(emitIr, std::ios::binary);
+    ir::serialize(stream, snapshot);
+    if ( ! stream.flush()) {
+      std::cerr << "could not write \"" << emitIr << "\"" << std::endl;
+      return 1;
     }
+    return 0;
+  }
+
+  const cpp::Mode cppMode = cppTable ? cpp::kTable
+    : cppStatic ? cpp::kStatic
+    : cppCache ? cpp::kCache : cpp::kSwitch;
+
+  //switch statements build values at run time, they need std containers
+  if (cppFlat && cppMode != cpp::kTable && cppMode != cpp::kStatic) {
+    std::cerr << "--cpp-flat requires --cpp-table or --cpp-static" << std::endl;
+    return 1;
+  }
+
+  const cpp::Options cppOptions(cppMode, cppFlat, cppStringView);
 
-    snapshot.dimensions = r.dimensions.enumerate();
+  /*
+   * generators only read the snapshot, up to --jobs of them run at once and
+   * each one writes its own file.
+   */
+  if ( ! graphPrinter && outDirectory != NULL) {
+    std::atomic< bool > failed(false);
 
-  } catch (const std::exception & e) { }
+    parallelFor(selected.size(), jobs, [&](const size_t i) {
+      const std::string path =
+        std::string(outDirectory) + "/" + selected[i]->file;
+
+      std::ofstream stream(path);
+      Printer p(stream);
+
+      const Generator::Pointer generator(selected[i]->create(cppOptions));
+      generator->generate(p, snapshot);
+
+      if ( ! stream.flush()) {
+        std::cerr << "could not write \"" << path << "\"" << std::endl;
+        failed = true;
+      }
+    });
+
+    return failed ? 1 : 0;
+  }
 
   //TODO(dmorilha): validate keys against the actual keys
   //
@@ -160,11 +440,11 @@ int main(int argc, char * * argv) {
     Generator::Pointer generator;
 
     if (cppCode) {
-      generator.reset(new CPPCodeGenerator());
+      generator.reset(new CPPCodeGenerator(cppOptions));
     } else if (cppHeader) {
-      generator.reset(new CPPHeaderGenerator());
+      generator.reset(new CPPHeaderGenerator(cppOptions));
     } else if (cppJsonCode) {
-      generator.reset(new CPPJsonCodeGenerator());
+      generator.reset(new CPPJsonCodeGenerator(cppOptions));
     } else if (cppJsonHeader) {
       generator.reset(new CPPJsonHeaderGenerator());
     } else if (dart) {
@@ -179,16 +459,39 @@ int main(int argc, char * * argv) {
       generator.reset(new PHPGenerator());
     } else {
       std::cout << "Available options are" << "\n"
+        << " --cache DIR: keeps processed input in DIR, created if missing, "
+        "and reuses it for the files and keys that did not change." << "\n"
+        << " --cpp-cache: C++ keys are resolved once per Configuration "
+        "instance and returned by reference." << "\n"
         << " --cpp-code: generates C++ code ouput." << "\n"
+        << " --cpp-flat: C++ arrays and dynamic keys are views of static "
+        "storage, sorted by key, instead of std::vector and std::map." << "\n"
         << " --cpp-header: generates C++ header output." << "\n"
+        << " --cpp-static: C++ keys switch between precomputed values and "
+        "return them by reference." << "\n"
+        << " --cpp-string-view: C++ strings are std::string_view into a "
+        "single pool of every generated string, output requires C++17." << "\n"
+        << " --cpp-table: C++ keys return precomputed values and C++ JSON "
+        "keys append precomputed fragments, looked up by context." << "\n"
         << " --dart: generates Dart output." << "\n"
+        << " --emit-ir FILE: writes the processed input to FILE instead of "
+        "generating output." << "\n"
+        << " --from-ir FILE: generates output from a file written by "
+        "--emit-ir, no YAML files are read." << "\n"
         << " --graph-printer: prints each key graph." << "\n"
         << " --java: generates Java output." << "\n"
+        << " --jobs N: processes keys and runs --targets on N threads (0 uses all "
+        "cores)." << "\n"
         << " --js: generates JS output." << "\n"
         << " --php: generates PHP output." << "\n"
+        << " --out-dir DIR: writes the --targets outputs into DIR, "
+        "generating them in parallel." << "\n"
         << " --python: generates Python output." << "\n"
         << " --set dimension:value[,value...] "
-        "limits a certain dimension to only these values." << "\n";
+        "limits a certain dimension to only these values." << "\n"
+        << " --targets NAME[,NAME...]: generators for --out-dir, any of "
+        "cpp-code, cpp-header, cpp-json-code, cpp-json-header, dart, java, "
+        "js, php and python." << "\n";
 
       return 0;
     }
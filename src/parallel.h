@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/*
+ * runs f(0) ... f(n - 1) on up to j threads. Indexes are handed out in
+ * order, the first exception thrown is rethrown on the calling thread.
+ */
+template < class F >
+void parallelFor(const size_t n, const int j, F && f) {
+  size_t jobs = j > 0 ? j : std::thread::hardware_concurrency();
+
+  if (jobs > n) {
+    jobs = n;
+  }
+
+  if (jobs <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      f(i);
+    }
+    return;
+  }
+
+  std::atomic< size_t > next(0);
+  std::exception_ptr error;
+  std::atomic_flag failed = ATOMIC_FLAG_INIT;
+
+  const auto worker = [&](void) {
+    try {
+      for (size_t i = next++; i < n; i = next++) {
+        f(i);
+      }
+    } catch (...) {
+      if ( ! failed.test_and_set()) {
+        error = std::current_exception();
+      }
+      next = n;
+    }
+  };
+
+  std::vector< std::thread > threads;
+  threads.reserve(jobs - 1);
+
+  for (size_t i = 1; i < jobs; ++i) {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+#endif //PARALLEL_H
@@ -246,6 +246,7 @@ void Parser::processValue(const YAML::Node & n, const Result & r, Value & v) con
   }
 
   v.content = content;
+  v.parse();
 }
 
 void Parser::processKeyKeys(Parser::Result & r, const Contexts & c,
@@ -269,7 +270,9 @@ void Parser::processKeyKeys(Parser::Result & r, const Contexts & c,
     }
 
     auto & property = value.push();
-    YAML::convert< std::string >::decode(item, property.second.content);
+    std::string content;
+    YAML::convert< std::string >::decode(item, content);
+    property.second.content = std::move(content);
     property.second.type = type;
   }
 
@@ -373,11 +376,25 @@ void Parser::processSets(Result & r, const YAML::Node & n) const {
   }
 }
 
+void Parser::processWidths(Result & r, const YAML::Node & n) const {
+  assert(n.IsMap());
+  for (const auto & node : n) {
+    const auto r1 = getString(node.first);
+    if (std::get< 1 >(r1)) {
+      assert(node.second.IsScalar());
+      const auto r2 = getString(node.second);
+      if (std::get< 1 >(r2)) {
+        r.widths[std::get< 0 >(r1)] = std::get< 0 >(r2);
+      }
+    }
+  }
+}
+
 void Parser::parse(const YAML::Node & root, Result & r) const {
   assert(root.IsSequence() || root.size() == 0);
   for (const auto & item : root) {
     assert(item.IsMap());
-    //first pass to find dimensions, namespaces and regular-expressions
+    //first pass to find dimensions, namespaces, widths and regular-expressions
     for (const auto & node : item) {
       const auto result = getString(node.first);
       if (std::get< 1 >(result)) {
@@ -390,6 +407,8 @@ void Parser::parse(const YAML::Node & root, Result & r) const {
           processRegularExpressions(r, node.second);
         } else if (key == "sets") {
           processSets(r, node.second);
+        } else if (key == "widths") {
+          processWidths(r, node.second);
         }
       }
     }
@@ -29,6 +29,7 @@ struct Parser {
   typedef std::map< std::string, Regex > RegularExpressions;
   typedef std::shared_ptr< std::set< std::string > > Set;
   typedef std::map< std::string, Set > Sets;
+  typedef std::map< std::string, std::string > Widths;
 
   struct Result {
     dimensions::DimensionTable dimensions;
@@ -40,6 +41,7 @@ struct Parser {
     Namespaces namespaces;
     RegularExpressions regexs;
     Sets sets;
+    Widths widths;
   };
 
   static Type::TYPES TagToType(const std::string &);
@@ -71,6 +73,8 @@ struct Parser {
   void processRegularExpressions(Result &, const YAML::Node &) const;
 
   void processSets(Result &, const YAML::Node &) const;
+
+  void processWidths(Result &, const YAML::Node &) const;
 };
 
 } //end of parser namespace
@@ -15,10 +15,9 @@ void PHPGenerator::structure (Printer & p, const ir::Structure & structure, cons
 
   p << "class " << id << " extends ConfigurationStructure {" << "\n";
 
-  ir::Structure::Properties properties = structure.properties;
-  std::sort(std::begin(properties), std::end(properties));
+  const auto properties = sorted(structure.properties);
 
-  for (const auto & property : properties) {
+  for (const ir::Structure::Property & property : properties) {
     p << tab(1) << "public $" << identifier(property.property) << ";";
 
     if ( ! property.comments.declaration.empty()) {
@@ -38,7 +37,7 @@ void PHPGenerator::structure (Printer & p, const ir::Structure & structure, cons
   p << "\n"
     << tab(1) << "public function __construct() {" << "\n";
 
-  for (const auto & property : properties) {
+  for (const ir::Structure::Property & property : properties) {
     p << tab(2) << "$this->" << identifier(property.property) << " = ";
 
     if (property.kind == ir::kArray
@@ -79,35 +78,24 @@ void PHPGenerator::structure (Printer & p, const ir::Structure & structure, cons
   }
 }
 
-void PHPGenerator::content(Printer & p, const Type::TYPES t,
-    const std::string & c) {
+void PHPGenerator::content(Printer & p, const Value & v) {
 
-  switch (t) {
-  case Type::kBoolean: {
-    using namespace std;
-
-    string content;
-
-    transform(begin(c), end(c),
-        back_inserter(content), ::tolower);
-
-    assert(content == "true" || content == "false");
-
-    p << content;
+  switch (v.type) {
+  case Type::kBoolean:
+    p << (v.scalar.boolean ? "true" : "false");
     break;
-  }
 
   case Type::kFloat:
   case Type::kInteger:
-    p << c;
+    p << v.content;
     break;
 
   case Type::kObject:
-    p << "new " << c << "()";
+    p << "new " << v.content << "()";
     break;
 
   case Type::kString:
-    p << "'" << c << "'";
+    p << "'" << v.content << "'";
     break;
 
   case Type::kUndefined:
@@ -138,7 +126,7 @@ void PHPGenerator::value(Printer & p, const Value & value,
           continue;
         }
         p << tab(t) << prefix << "[] = ";
-        content(p, item.second.type, item.second.content);
+        content(p, item.second);
         p << ";" << "\n";
       }
     } else if (value.type == Type::kObject) {
@@ -169,7 +157,7 @@ void PHPGenerator::value(Printer & p, const Value & value,
     assert( ! value.content.empty() || value.type == Type::kString);
     assert( ! value.ignore);
     p << tab(t) << prefix << " = ";
-    content(p, value.type, value.content);
+    content(p, value);
     p << ";" << "\n";
   }
 }
@@ -294,12 +282,11 @@ void PHPGenerator::configurationClass(Printer & p, const ir::Snapshot & snapshot
     << "\n";
 
   {
-    ir::Keys keys = snapshot.keys;
-    std::sort(std::begin(keys), std::end(keys));
+    const auto keys = sorted(snapshot.keys);
 
     p << tab(1) << "//print each configuration key" << "\n";
 
-    for (const auto & key : keys) {
+    for (const ir::Key & key : keys) {
       this->key(p, key);
     }
   }
@@ -311,15 +298,14 @@ void PHPGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dimen
 
   const std::string className = constantify(dimension.dimension);
 
-  ir::DimensionEnumeration::Values values = dimension.values;
-  std::sort(std::begin(values), std::end(values));
+  const auto values = sorted(dimension.values);
 
   p << "//print each dimension class" << "\n"
     << "\n"
     << "class " << className << " {" << "\n"
     << tab(1) << "//print enumeration" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(1) << "const " << constantify(value.first) << " = " << value.second << ";" << "\n";
   }
 
@@ -327,7 +313,7 @@ void PHPGenerator::dimension(Printer & p, const ir::DimensionEnumeration & dimen
     << tab(1) << "//print look-up table" << "\n"
     << tab(1) << "static $table = array(" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(2) << "'" << value.first << "' => " << className << "::" << constantify(value.first) << "," << "\n";
   }
 
@@ -340,11 +326,9 @@ void PHPGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
   header(p, snapshot.namespaces);
 
   {
-    ir::Structures structures = snapshot.structures;
-
-    if ( ! structures.empty()) {
+    if ( ! snapshot.structures.empty()) {
       //php allows declarings classes in any sequence.
-      std::sort(std::begin(structures), std::end(structures));
+      const auto structures = sorted(snapshot.structures);
 
       p << "class ConfigurationStructure extends \\ArrayObject {" << "\n"
         << tab(1) << "public function offsetGet($k) {" << "\n"
@@ -353,7 +337,7 @@ void PHPGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
         << "}" << "\n"
         << "\n";
 
-      for (const auto & item : structures) {
+      for (const ir::Structure & item : structures) {
         structure(p, item, snapshot.namespaces);
       }
     }
@@ -15,10 +15,9 @@ void PythonGenerator::structure (Printer & p, const ir::Structure & structure, c
 
   p << "class " << id << ":" << "\n";
 
-  ir::Structure::Properties properties = structure.properties;
-  std::sort(std::begin(properties), std::end(properties));
+  const auto properties = sorted(structure.properties);
 
-  for (const auto & property : properties) {
+  for (const ir::Structure::Property & property : properties) {
     p << tab(1) << identifier(property.property) << " = None;";
 
     if ( ! property.comments.declaration.empty()) {
@@ -38,7 +37,7 @@ void PythonGenerator::structure (Printer & p, const ir::Structure & structure, c
   p << "\n"
     << tab(1) << "def __init__(self):" << "\n";
 
-  for (const auto & property : properties) {
+  for (const ir::Structure::Property & property : properties) {
     p << tab(2) << "self." << identifier(property.property) << " = ";
 
     if (property.kind == ir::kDynamic) {
@@ -80,35 +79,24 @@ void PythonGenerator::structure (Printer & p, const ir::Structure & structure, c
   p << "\n";
 }
 
-void PythonGenerator::content(Printer & p, const Type::TYPES t,
-    const std::string & c) {
+void PythonGenerator::content(Printer & p, const Value & v) {
 
-  switch (t) {
-  case Type::kBoolean: {
-    using namespace std;
-
-    string content;
-
-    transform(begin(c), end(c),
-        back_inserter(content), ::tolower);
-
-    assert(content == "true" || content == "false");
-
-    p << content;
+  switch (v.type) {
+  case Type::kBoolean:
+    p << (v.scalar.boolean ? "true" : "false");
     break;
-  }
 
   case Type::kFloat:
   case Type::kInteger:
-    p << c;
+    p << v.content;
     break;
 
   case Type::kObject:
-    p << " " << c << "()";
+    p << " " << v.content << "()";
     break;
 
   case Type::kString:
-    p << "'" << c << "'";
+    p << "'" << v.content << "'";
     break;
 
   case Type::kUndefined:
@@ -139,7 +127,7 @@ void PythonGenerator::value(Printer & p, const Value & value,
           continue;
         }
         p << tab(t) << prefix << ".append(";
-        content(p, item.second.type, item.second.content);
+        content(p, item.second);
         p << ")" << "\n";
       }
     } else if (value.type == Type::kObject) {
@@ -171,7 +159,7 @@ void PythonGenerator::value(Printer & p, const Value & value,
     assert( ! value.content.empty() || value.type == Type::kString);
     assert( ! value.ignore);
     p << tab(t) << prefix << " = ";
-    content(p, value.type, value.content);
+    content(p, value);
     p << "\n";
   }
 }
@@ -315,12 +303,11 @@ void PythonGenerator::configurationClass(Printer & p, const ir::Snapshot & snaps
   }
 
   {
-    ir::Keys keys = snapshot.keys;
-    std::sort(std::begin(keys), std::end(keys));
+    const auto keys = sorted(snapshot.keys);
 
     p << tab(1) << "# print each configuration key" << "\n";
 
-    for (const auto & key : keys) {
+    for (const ir::Key & key : keys) {
       this->key(p, key, snapshot.dimensions);
     }
   }
@@ -332,15 +319,14 @@ void PythonGenerator::dimension(Printer & p, const ir::DimensionEnumeration & di
 
   const std::string className = constantify(dimension.dimension);
 
-  ir::DimensionEnumeration::Values values = dimension.values;
-  std::sort(std::begin(values), std::end(values));
+  const auto values = sorted(dimension.values);
 
   p << "# print each dimension class" << "\n"
     << "\n"
     << "class " << className << ":" << "\n"
     << tab(1) << "# print enumeration" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(1) << constantify(value.first) << " = " << value.second << "\n";
   }
 
@@ -348,7 +334,7 @@ void PythonGenerator::dimension(Printer & p, const ir::DimensionEnumeration & di
     << tab(1) << "# print look-up table" << "\n"
     << tab(1) << "table = {" << "\n";
 
-  for (const auto & value : values) {
+  for (const ir::DimensionEnumeration::Value & value : values) {
     p << tab(2) << "'" << value.first << "' : " << constantify(value.first) << "," << "\n";
   }
 
@@ -360,11 +346,9 @@ void PythonGenerator::generate(Printer & p, const ir::Snapshot & snapshot) {
   header(p, snapshot.namespaces);
 
   {
-    ir::Structures structures = snapshot.structures;
-
-    std::sort(std::begin(structures), std::end(structures));
+    const auto structures = sorted(snapshot.structures);
 
-    for (const auto & item : structures) {
+    for (const ir::Structure & item : structures) {
       structure(p, item, snapshot.namespaces);
     }
   }
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <assert.h>
+
+#include <memory>
+
+#include "resolver.h"
+
+void Resolver::overlay(Value & target, const Value & source) {
+  if ( ! source.properties.empty()) {
+    target.type = source.type;
+
+    if (source.type == Type::kArray) {
+      for (const auto & item : source.properties) {
+        if ( ! item.second.ignore) {
+          target.properties.push_back(item);
+        }
+      }
+
+    } else if (source.type == Type::kObject
+        || source.type == Type::kDynamic) {
+      for (const auto & item : source.properties) {
+        if (item.second.ignore) {
+          assert(source.type == Type::kDynamic);
+          continue;
+        }
+
+        Value::Properties::iterator iterator = std::begin(target.properties);
+        for (; iterator != std::end(target.properties); ++iterator) {
+          if (iterator->first == item.first) {
+            break;
+          }
+        }
+
+        if (iterator == std::end(target.properties)) {
+          target.properties.push_back({item.first, Value()});
+          iterator = std::end(target.properties) - 1;
+        }
+
+        overlay(iterator->second, item.second);
+      }
+
+    } else {
+      assert(false);
+    }
+
+  } else if (source.type != Type::kUndefined) {
+    assert( ! source.ignore);
+    target.type = source.type;
+    target.content = source.content;
+    target.scalar = source.scalar;
+  }
+}
+
+void Resolver::switches(const ir::Dimension & d, Switches & s) {
+  if ( ! (d.skip || d.values.empty())) {
+    auto & indexes = s[d.dimension];
+    for (const auto & item : d.values) {
+      indexes.insert(item.index);
+    }
+  }
+
+  for (const auto & item : d.values) {
+    if (static_cast< bool >(item.dimension)) {
+      switches(*item.dimension, s);
+    }
+  }
+
+  if (static_cast< bool >(d.next)) {
+    switches(*d.next, s);
+  }
+}
+
+Resolver::Switches Resolver::switches(const ir::Key & k) {
+  Switches result;
+  if (static_cast< bool >(k.dimension)) {
+    switches(*k.dimension, result);
+  }
+  return result;
+}
+
+namespace {
+/*
+ * goes down d the way generated code does, calling leaf(path, value)
+ * wherever resolution stops. take(d, position) filters the positions followed at
+ * each switch, v is not overlaid when null. Skipped dimensions fall
+ * through to their next one, pending holds those still to be visited.
+ */
+template < class T, class L >
+void walk(const ir::Dimension & d, std::vector< const ir::Dimension * > & pending,
+    Resolver::Table::Path & path, Value * const v, const T & take,
+    const L & leaf);
+
+template < class T, class L >
+void finish(std::vector< const ir::Dimension * > & pending,
+    Resolver::Table::Path & path, Value * const v, const T & take,
+    const L & leaf) {
+  if (pending.empty()) {
+    leaf(path, v);
+    return;
+  }
+
+  const ir::Dimension * const d = pending.back();
+  pending.pop_back();
+  walk(*d, pending, path, v, take, leaf);
+  pending.push_back(d);
+}
+
+template < class T, class L >
+void walk(const ir::Dimension & d, std::vector< const ir::Dimension * > & pending,
+    Resolver::Table::Path & path, Value * const v, const T & take,
+    const L & leaf) {
+  if (d.skip || d.values.empty()) {
+    assert(d.values.size() <= 1);
+
+    if (static_cast< bool >(d.next)) {
+      pending.push_back(d.next.get());
+    }
+
+    if ( ! d.values.empty()) {
+      const auto & item = d.values.front();
+      if (v != nullptr) {
+        Resolver::overlay(*v, item.value);
+      }
+      if (static_cast< bool >(item.dimension)) {
+        walk(*item.dimension, pending, path, v, take, leaf);
+      } else {
+        finish(pending, path, v, take, leaf);
+      }
+    } else {
+      finish(pending, path, v, take, leaf);
+    }
+
+    if (static_cast< bool >(d.next)) {
+      pending.pop_back();
+    }
+    return;
+  }
+
+  for (size_t i = 0; i <= d.values.size(); ++i) {
+    if ( ! take(d, i)) {
+      continue;
+    }
+
+    path.emplace_back(&d, i);
+
+    if (i < d.values.size()) {
+      const auto & item = d.values[i];
+      std::unique_ptr< Value > copy;
+      if (v != nullptr) {
+        copy.reset(new Value(*v));
+        Resolver::overlay(*copy, item.value);
+      }
+      if (static_cast< bool >(item.dimension)) {
+        walk(*item.dimension, pending, path, copy.get(), take, leaf);
+      } else {
+        finish(pending, path, copy.get(), take, leaf);
+      }
+    } else if (static_cast< bool >(d.next)) {
+      walk(*d.next, pending, path, v, take, leaf);
+    } else {
+      finish(pending, path, v, take, leaf);
+    }
+
+    path.pop_back();
+  }
+}
+} //end of anonymous namespace
+
+Resolver::Table::Table(const ir::Key & k) :
+  size(1) {
+  for (const auto & item : Resolver::switches(k)) {
+    switches.emplace_back(item.first,
+        Values(std::begin(item.second), std::end(item.second)));
+    size = size > kLimit ? size : size * (item.second.size() + 1);
+  }
+
+  Value value;
+  value.type = k.value.type;
+  overlay(value, k.value);
+
+  if ( ! static_cast< bool >(k.dimension)) {
+    paths.emplace(Path(), 0);
+    leaves.push_back(std::move(value));
+    return;
+  }
+
+  std::vector< const ir::Dimension * > pending;
+  Path path;
+
+  walk(*k.dimension, pending, path, &value,
+      [](const ir::Dimension &, const size_t) { return true; },
+      [&](const Path & p, Value * const v) {
+        paths.emplace(p, leaves.size());
+        leaves.push_back(*v);
+      });
+
+  if (switches.empty() || size > kLimit) {
+    return;
+  }
+
+  index.reserve(size);
+
+  for (size_t i = 0; i < size; ++i) {
+    const Indexes indexes = this->indexes(i);
+
+    //the value taken is the one matching the context, if any
+    const auto take = [&](const ir::Dimension & d, const size_t position) {
+      const auto iterator = indexes.find(d.dimension);
+      const unsigned int index = iterator != std::end(indexes) ?
+        iterator->second : 0;
+      for (size_t j = 0; j < d.values.size(); ++j) {
+        if (d.values[j].index == index) {
+          return j == position;
+        }
+      }
+      return position == d.values.size();
+    };
+
+    walk(*k.dimension, pending, path, nullptr, take,
+        [&](const Path & p, Value * const) { index.push_back(leaf(p)); });
+  }
+
+  assert(index.size() == size);
+}
+
+size_t Resolver::Table::leaf(const Path & p) const {
+  const auto iterator = paths.find(p);
+  assert(iterator != std::end(paths));
+  return iterator->second;
+}
+
+Resolver::Indexes Resolver::Table::indexes(const size_t i) const {
+  Indexes result;
+  size_t n = i;
+
+  for (auto iterator = switches.rbegin(); iterator != switches.rend();
+      ++iterator) {
+    const size_t local = n % (iterator->second.size() + 1);
+    n /= iterator->second.size() + 1;
+    if (local > 0) {
+      result[iterator->first] = iterator->second[local - 1];
+    }
+  }
+
+  return result;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ir.h"
+#include "value.h"
+
+/*
+ * evaluates a key's dimension tree at compile time, the same way generated
+ * code does at run time: overrides are applied in tree order, arrays are
+ * appended to, objects and dynamics are merged by property name.
+ */
+struct Resolver {
+  //dimension name to value index, missing dimensions are NONE
+  typedef std::map< std::string, unsigned int > Indexes;
+
+  //dimensions a key switches on and the value indexes it mentions for each
+  typedef std::map< std::string, std::set< unsigned int > > Switches;
+
+  static void overlay(Value &, const Value &);
+
+  static void switches(const ir::Dimension &, Switches &);
+  static Switches switches(const ir::Key &);
+
+  /*
+   * every combination of the value indexes a key switches on, NONE
+   * included as 0. Combinations are numbered with the last dimension
+   * varying fastest.
+   *
+   * values are resolved once per path down the key's dimension tree, not
+   * once per combination: leaves holds one value per path in tree order
+   * and index maps each combination to its leaf. Past kLimit combinations
+   * index stays empty and generators switch over the tree instead.
+   */
+  struct Table {
+    typedef std::vector< unsigned int > Values;
+    typedef std::vector< std::pair< std::string, Values > > Switches;
+
+    //node and position of the value taken there, values.size() for none
+    typedef std::vector< std::pair< const ir::Dimension *, size_t > > Path;
+
+    static const size_t kLimit = 4096;
+
+    Switches switches;
+    size_t size; //exact up to kLimit
+
+    std::vector< Value > leaves;
+    std::vector< size_t > index;
+    std::map< Path, size_t > paths;
+
+    Table(const ir::Key &);
+
+    Indexes indexes(const size_t) const;
+
+    size_t leaf(const Path &) const;
+  };
+};
+
+#endif //RESOLVER_H
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <stdexcept>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "serializer.h"
+
+namespace {
+const char MAGIC[] = "ZEUSIR";
+const uint32_t VERSION = 2;
+
+//the smallest encoded value: type, reset, ignore, content, alias, properties
+const size_t VALUE = 4 * 6;
+
+void append(std::string & o, const uint32_t v) {
+  for (int i = 0; i < 4; ++i) {
+    o += static_cast< char >((v >> (i * 8)) & 0xff);
+  }
+}
+
+struct Writer {
+  typedef std::map< std::string, uint32_t > Strings;
+
+  Strings strings;
+  std::vector< const std::string * > table;
+  std::string body;
+
+  void integer(const uint32_t v) {
+    append(body, v);
+  }
+
+  void string(const std::string & s) {
+    const auto result = strings.emplace(s, table.size());
+    if (result.second) {
+      table.push_back(&result.first->first);
+    }
+    integer(result.first->second);
+  }
+
+  void value(const Value & v) {
+    integer(v.type);
+    integer(v.reset);
+    integer(v.ignore);
+    string(v.content);
+    string(v.alias);
+    integer(v.properties.size());
+    for (const auto & item : v.properties) {
+      string(item.first);
+      value(item.second);
+    }
+  }
+
+  void dimension(const ir::DimensionPointer & d) {
+    integer(static_cast< bool >(d));
+    if ( ! static_cast< bool >(d)) {
+      return;
+    }
+    string(d->dimension);
+    integer(d->skip);
+    integer(d->values.size());
+    for (const auto & item : d->values) {
+      integer(item.index);
+      value(item.value);
+      dimension(item.dimension);
+    }
+    dimension(d->next);
+  }
+
+  void snapshot(const ir::Snapshot & s) {
+    integer(s.namespaces.size());
+    for (const auto & item : s.namespaces) {
+      string(item);
+    }
+
+    integer(s.dimensions.size());
+    for (const auto & item : s.dimensions) {
+      string(item.first);
+      string(item.second.dimension);
+      integer(item.second.values.size());
+      for (const auto & value : item.second.values) {
+        string(value.first);
+        integer(value.second);
+      }
+    }
+
+    integer(s.structures.size());
+    for (const auto & item : s.structures) {
+      string(item.identifier);
+      integer(item.properties.size());
+      for (const auto & property : item.properties) {
+        string(property.property);
+        string(property.type);
+        integer(property.kind);
+        string(property.width);
+        string(property.comments.declaration);
+      }
+      integer(item.aliases.size());
+      for (const auto & alias : item.aliases) {
+        string(alias);
+      }
+    }
+
+    integer(s.keys.size());
+    for (const auto & item : s.keys) {
+      string(item.key);
+      value(item.value);
+      string(item.type);
+      dimension(item.dimension);
+      integer(item.cache);
+      integer(item.kind);
+      string(item.alias);
+      string(item.width);
+    }
+  }
+};
+
+struct Reader {
+  const char * c;
+  const char * const end;
+  std::vector< std::string > table;
+
+  Reader(const char * const b, const size_t s) :
+    c(b), end(b + s) { }
+
+  const char * take(const size_t n) {
+    if (static_cast< size_t >(end - c) < n) {
+      throw std::runtime_error("truncated snapshot");
+    }
+    const char * const result = c;
+    c += n;
+    return result;
+  }
+
+  uint32_t integer(void) {
+    const unsigned char * const b =
+      reinterpret_cast< const unsigned char * >(take(4));
+    return b[0] | b[1] << 8 | b[2] << 16 | static_cast< uint32_t >(b[3]) << 24;
+  }
+
+  /*
+   * number of items that follow, each one takes at least n bytes. Checked
+   * before anything gets allocated for them, a corrupt count must not turn
+   * into a huge allocation.
+   */
+  uint32_t count(const size_t n) {
+    const uint32_t result = integer();
+    if (result > static_cast< size_t >(end - c) / n) {
+      throw std::runtime_error("invalid count");
+    }
+    return result;
+  }
+
+  ir::Kind kind(void) {
+    const uint32_t result = integer();
+    if (result > ir::kDynamic) {
+      throw std::runtime_error("invalid kind");
+    }
+    return static_cast< ir::Kind >(result);
+  }
+
+  const std::string & string(void) {
+    const uint32_t i = integer();
+    if (i >= table.size()) {
+      throw std::runtime_error("invalid string");
+    }
+    return table[i];
+  }
+
+  void value(Value & v) {
+    const uint32_t type = integer();
+    if (type > Type::kUnknown) {
+      throw std::runtime_error("invalid type");
+    }
+    v.type = static_cast< Type::TYPES >(type);
+    v.reset = integer();
+    v.ignore = integer();
+    v.content = string();
+    v.alias = string();
+    v.parse();
+    v.properties.resize(count(4 + VALUE));
+    for (auto & item : v.properties) {
+      item.first = string();
+      value(item.second);
+    }
+  }
+
+  void dimension(ir::DimensionPointer & d) {
+    if (integer() == 0) {
+      return;
+    }
+    d.reset(new ir::Dimension(string()));
+    d->skip = integer();
+    const uint32_t size = count(4 + VALUE + 4);
+    d->values.reserve(size);
+    for (uint32_t i = 0; i < size; ++i) {
+      d->values.emplace_back(integer());
+      ir::DimensionValue & item = d->values.back();
+      value(item.value);
+      dimension(item.dimension);
+    }
+    dimension(d->next);
+  }
+
+  void snapshot(ir::Snapshot & s) {
+    if (strncmp(take(sizeof(MAGIC) - 1), MAGIC, sizeof(MAGIC) - 1) != 0
+        || integer() != VERSION) {
+      throw std::runtime_error("not a snapshot");
+    }
+
+    table.resize(count(4));
+    for (auto & item : table) {
+      const uint32_t length = count(1);
+      item.assign(take(length), length);
+    }
+
+    s.namespaces.resize(count(4));
+    for (auto & item : s.namespaces) {
+      item = string();
+    }
+
+    for (uint32_t i = count(12); i > 0; --i) {
+      ir::DimensionEnumeration & item = s.dimensions[string()];
+      item.dimension = string();
+      item.values.resize(count(8));
+      for (auto & value : item.values) {
+        value.first = string();
+        value.second = integer();
+      }
+    }
+
+    for (uint32_t i = count(12); i > 0; --i) {
+      s.structures.emplace_back(string(), ir::Structure::Properties(),
+          ir::Structure::Aliases());
+      ir::Structure & item = s.structures.back();
+      for (uint32_t j = count(20); j > 0; --j) {
+        item.properties.emplace_back(string());
+        ir::Structure::Property & property = item.properties.back();
+        property.type = string();
+        property.kind = kind();
+        property.width = string();
+        property.comments.declaration = string();
+      }
+      item.aliases.resize(count(4));
+      for (auto & alias : item.aliases) {
+        alias = string();
+      }
+    }
+
+    for (uint32_t i = count(4 + VALUE + 4 * 6); i > 0; --i) {
+      s.keys.emplace_back(string());
+      ir::Key & item = s.keys.back();
+      value(item.value);
+      item.type = string();
+      dimension(item.dimension);
+      item.cache = integer();
+      item.kind = kind();
+      item.alias = string();
+      item.width = string();
+    }
+
+    if (c != end) {
+      throw std::runtime_error("trailing data");
+    }
+  }
+};
+} //end of anonymous namespace
+
+namespace ir {
+  void serialize(std::ostream & o, const Snapshot & s) {
+    Writer writer;
+    writer.snapshot(s);
+
+    std::string header(MAGIC);
+    append(header, VERSION);
+    append(header, writer.table.size());
+
+    for (const auto item : writer.table) {
+      append(header, item->size());
+      header += *item;
+    }
+
+    o << header << writer.body;
+  }
+
+  bool deserialize(const char * const d, const size_t n, Snapshot & s) {
+    Reader reader(d, n);
+    Snapshot result;
+
+    //std::bad_alloc and std::length_error included
+    try {
+      reader.snapshot(result);
+    } catch (const std::exception &) {
+      return false;
+    }
+
+    s = std::move(result);
+    return true;
+  }
+
+  bool load(const char * const f, Snapshot & s) {
+    const int fd = open(f, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat st;
+    bool result = false;
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void * const data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        result = deserialize(static_cast< const char * >(data), st.st_size, s);
+        munmap(data, st.st_size);
+      }
+    }
+
+    close(fd);
+    return result;
+  }
+} //end of ir namespace
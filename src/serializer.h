@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef SERIALIZER_H
+#define SERIALIZER_H
+
+#include <cstddef>
+#include <ostream>
+
+#include "ir.h"
+
+/*
+ * binary form of an ir::Snapshot. Integers are little endian uint32, every
+ * string is stored once in a table at the beginning and referenced by its
+ * position afterwards:
+ *
+ *   "ZEUSIR" version
+ *   string count, (length, bytes) ...
+ *   namespaces, dimensions, structures, keys
+ *
+ * Everything is length prefixed, a file is decoded in a single forward
+ * pass straight out of its mapping.
+ *
+ * Values keep what generators use, regular expressions and sets are only
+ * needed by the front end and are left out.
+ */
+namespace ir {
+  void serialize(std::ostream &, const Snapshot &);
+
+  //false if data is not a complete snapshot of the current version
+  bool deserialize(const char *, const size_t, Snapshot &);
+
+  //maps the file instead of reading it, false on any failure
+  bool load(const char *, Snapshot &);
+} //end of ir namespace
+
+#endif //SERIALIZER_H
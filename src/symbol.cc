@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <mutex>
+#include <unordered_set>
+
+#include "symbol.h"
+
+namespace {
+//nodes never move, entries are never removed
+struct Table {
+  std::mutex mutex;
+  std::unordered_set< std::string > strings;
+};
+
+Table & table(void) {
+  static Table * const t = new Table();
+  return *t;
+}
+} //end of anonymous namespace
+
+const std::string * Symbol::intern(const std::string & s) {
+  Table & t = table();
+  std::lock_guard< std::mutex > lock(t.mutex);
+  return &*t.strings.insert(s).first;
+}
+
+const std::string * Symbol::intern(std::string && s) {
+  Table & t = table();
+  std::lock_guard< std::mutex > lock(t.mutex);
+  return &*t.strings.insert(std::move(s)).first;
+}
+
+const std::string * Symbol::blank(void) {
+  static const std::string * const e = intern(std::string());
+  return e;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+/*
+ * interned string. Every distinct text is stored once for the lifetime of
+ * the process, a Symbol only points at it: copies are a pointer copy and
+ * equality is a pointer compare. Interning is thread safe.
+ */
+class Symbol {
+  const std::string * s_;
+
+  static const std::string * intern(const std::string &);
+  static const std::string * intern(std::string &&);
+  static const std::string * blank(void);
+
+public:
+  typedef std::string::const_iterator const_iterator;
+
+  Symbol(void) : s_(blank()) { }
+  Symbol(const std::string & s) : s_(intern(s)) { }
+  Symbol(std::string && s) : s_(intern(std::move(s))) { }
+  Symbol(const char * const s) : s_(intern(std::string(s))) { }
+
+  operator const std::string & (void) const { return *s_; }
+  const std::string & str(void) const { return *s_; }
+
+  bool empty(void) const { return s_->empty(); }
+  size_t size(void) const { return s_->size(); }
+  const char * c_str(void) const { return s_->c_str(); }
+  const char * data(void) const { return s_->data(); }
+  char operator [] (const size_t i) const { return (*s_)[i]; }
+  const_iterator begin(void) const { return s_->begin(); }
+  const_iterator end(void) const { return s_->end(); }
+
+  void clear(void) { s_ = blank(); }
+
+  size_t hash(void) const { return std::hash< const void * >()(s_); }
+
+  bool operator == (const Symbol & o) const { return s_ == o.s_; }
+  bool operator != (const Symbol & o) const { return s_ != o.s_; }
+  bool operator < (const Symbol & o) const { return s_ != o.s_ && *s_ < *o.s_; }
+
+  bool operator == (const std::string & o) const { return *s_ == o; }
+  bool operator != (const std::string & o) const { return *s_ != o; }
+  bool operator == (const char * const o) const { return *s_ == o; }
+  bool operator != (const char * const o) const { return *s_ != o; }
+};
+
+inline std::string operator + (const std::string & a, const Symbol & b) {
+  return a + b.str();
+}
+
+inline std::string operator + (const Symbol & a, const std::string & b) {
+  return a.str() + b;
+}
+
+inline std::string operator + (const char * const a, const Symbol & b) {
+  return a + b.str();
+}
+
+inline std::string operator + (const Symbol & a, const char * const b) {
+  return a.str() + b;
+}
+
+inline std::ostream & operator << (std::ostream & o, const Symbol & s) {
+  return o << s.str();
+}
+
+namespace std {
+  template < >
+  struct hash< Symbol > {
+    size_t operator () (const Symbol & s) const { return s.hash(); }
+  };
+} //end of std namespace
+
+#endif //SYMBOL_H
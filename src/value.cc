@@ -4,8 +4,34 @@
  * See the accompanying LICENSE file for terms.
  */
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "value.h"
 
+void Value::parse(void) {
+  switch (type) {
+  case Type::kBoolean: {
+    std::string c(content);
+    std::transform(std::begin(c), std::end(c), std::begin(c), ::tolower);
+    assert(c == "true" || c == "false");
+    scalar.boolean = c == "true";
+    break;
+  }
+
+  case Type::kFloat:
+    scalar.floating = strtod(content.c_str(), NULL);
+    break;
+
+  case Type::kInteger:
+    scalar.integer = strtoll(content.c_str(), NULL, 0);
+    break;
+
+  default:
+    break;
+  }
+}
+
 void Value::push(const Strings & s, const Type::TYPES t) {
   for (const auto & item : s) {
     properties.push_back({"", Value(t, item)});
@@ -15,6 +41,7 @@ void Value::push(const Strings & s, const Type::TYPES t) {
 void Value::set(const bool c) {
   assert(type == Type::kBoolean);
   content = c ? "true" : "false";
+  scalar.boolean = c;
 }
 
 void Value::set(const std::string & c) {
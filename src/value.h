@@ -8,10 +8,12 @@
 #define VALUE_H
 
 #include <assert.h>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
 #include "common.h"
+#include "symbol.h"
 
 struct Type {
   enum TYPES {
@@ -53,7 +55,7 @@ struct Type {
 };
 
 struct Value {
-  typedef std::pair< std::string, Value > Property;
+  typedef std::pair< Symbol, Value > Property;
   typedef std::vector< Property > Properties;
 
   typedef std::vector< bool > Booleans;
@@ -63,38 +65,50 @@ struct Value {
 
   Type::TYPES type;
   bool reset;
-  std::string content;
+  Symbol content; //interned, as are alias and property names
+
+  //native form of boolean, float and integer content, tagged by type
+  union Scalar {
+    bool boolean;
+    double floating;
+    int64_t integer;
+  } scalar;
+
   Properties properties;
   Regex regex;
   Set set_;
-  std::string alias;
+  Symbol alias;
   bool ignore;
 
-  Value(void): type(Type::kUndefined), reset(false), ignore(false) { }
+  Value(void): type(Type::kUndefined), reset(false), scalar(),
+    ignore(false) { }
 
   Value(const Type::TYPES t, const std::string & c, const bool r = false):
-    type(t), reset(r), content(c), ignore(false) { }
+    type(t), reset(r), content(c), scalar(), ignore(false) { parse(); }
 
   Value(const Type::TYPES t, std::string && c, const bool r = false):
-    type(t), reset(r), content(std::move(c)), ignore(false) { }
+    type(t), reset(r), content(std::move(c)), scalar(), ignore(false) {
+    parse();
+  }
 
   Value(const Type::TYPES t, const Strings & c, const bool r = false):
-    type(Type::kArray), reset(r), ignore(false) { push(c, t); }
+    type(Type::kArray), reset(r), scalar(), ignore(false) { push(c, t); }
 
   Value(const Type::TYPES t, Strings && c, const bool r = false):
-    type(Type::kArray), reset(r), ignore(false) { push(c, t); }
+    type(Type::kArray), reset(r), scalar(), ignore(false) { push(c, t); }
 
   Value(const std::string & c, const bool r = false):
-    type(Type::kString), reset(r), content(c), ignore(false) { }
+    type(Type::kString), reset(r), content(c), scalar(), ignore(false) { }
 
   Value(const char * const c, const bool r = false):
-    type(Type::kString), reset(r), content(c), ignore(false) { }
+    type(Type::kString), reset(r), content(c), scalar(), ignore(false) { }
 
   Value(std::string && c, const bool r = false):
-    type(Type::kString), reset(r), content(std::move(c)), ignore(false) { }
+    type(Type::kString), reset(r), content(std::move(c)), scalar(),
+    ignore(false) { }
 
   Value(const Booleans & c, const bool r = false):
-    type(Type::kArray), reset(r), ignore(false) {
+    type(Type::kArray), reset(r), scalar(), ignore(false) {
     properties.reserve(c.size());
     for (const auto item : c) {
       properties.push_back({"",
@@ -104,7 +118,7 @@ struct Value {
 
   Value(const bool c):
     type(Type::kBoolean), reset(false), content(c ? "true" : "false"),
-    ignore(false) { }
+    ignore(false) { scalar.boolean = c; }
 
   Value(const Floats &, const bool r = false);
 
@@ -112,23 +126,24 @@ struct Value {
 
   Value(const float c):
     type(Type::kFloat), reset(false), content(std::to_string(c)),
-    ignore(false) { }
+    ignore(false) { scalar.floating = c; }
 
   Value(const double c):
     type(Type::kFloat), reset(false), content(std::to_string(c)),
-    ignore(false) { }
+    ignore(false) { scalar.floating = c; }
 
   template < class T >
   Value(const T c):
     type(Type::kInteger), reset(false), content(std::to_string(c)),
-    ignore(false) { }
+    ignore(false) { scalar.integer = c; }
 
   Value(const Value::Properties & p) :
-    type(Type::kUndefined), reset(false), properties(p), ignore(false) { }
+    type(Type::kUndefined), reset(false), scalar(), properties(p),
+    ignore(false) { }
 
   Value(Properties && p) :
-    type(Type::kUndefined), reset(false), properties(std::move(p)),
-    ignore(false) { }
+    type(Type::kUndefined), reset(false), scalar(),
+    properties(std::move(p)), ignore(false) { }
 
   Value(const Value &) = default;
   Value(Value &&) = default;
@@ -136,6 +151,12 @@ struct Value {
   Value & operator = (const Value &) = default;
   Value & operator = (Value &&) = default;
 
+  /*
+   * fills scalar in from content, according to type. Integers read as the
+   * C++ literal would, booleans ignore case.
+   */
+  void parse(void);
+
   void push(const Strings &, Type::TYPES t = Type::kString);
 
   template < class T >
@@ -168,10 +189,8 @@ struct Value {
   template < class T >
   void set(const T & c) {
     assert(type == Type::kFloat || type == Type::kInteger);
-    if ( ! content.empty()) {
-      content.clear();
-    }
-    content.push_back(std::to_string(c));
+    content = std::to_string(c);
+    parse();
   }
 };
 
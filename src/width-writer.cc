@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <assert.h>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include "width-writer.h"
+
+bool WidthWriter::valid(const std::string & t, const std::string & w) {
+  if (t == "integer") {
+    return w == "int8" || w == "int16" || w == "int32" || w == "int64";
+  } else if (t == "float") {
+    return w == "float" || w == "double";
+  }
+  return false;
+}
+
+bool WidthWriter::fits(const Value & v, const std::string & w) {
+  if (v.type == Type::kInteger) {
+    const int64_t i = v.scalar.integer;
+    if (w == "int8") {
+      return i >= INT8_MIN && i <= INT8_MAX;
+    } else if (w == "int16") {
+      return i >= INT16_MIN && i <= INT16_MAX;
+    } else if (w == "int32") {
+      return i >= INT32_MIN && i <= INT32_MAX;
+    }
+  } else if (v.type == Type::kFloat && w == "float") {
+    //neither overflows to infinity nor underflows to zero
+    const double d = v.scalar.floating;
+    return ! std::isfinite(d) || d == 0
+      || (std::fabs(d) <= FLT_MAX && static_cast< float >(d) != 0);
+  }
+  return true;
+}
+
+/*
+ * goes through v the way generators do, t and k being its type and kind
+ * and w its width. n names v in error messages.
+ */
+void WidthWriter::check(const Value & v, const std::string & t,
+    const ir::Kind k, const std::string & w, const std::string & n,
+    const Structures & s) {
+  if (v.ignore || v.type == Type::kUndefined) {
+    return;
+  }
+
+  if (k != ir::kNone) {
+    for (const auto & item : v.properties) {
+      check(item.second, t, ir::kNone, w, n, s);
+    }
+    return;
+  }
+
+  if (t == "integer" || t == "float") {
+    if ( ! w.empty() && ! fits(v, w)) {
+      std::cerr << "value \"" << v.content.c_str() << "\" of \"" << n
+        << "\" does not fit width \"" << w << "\"" << std::endl;
+      assert(false); //value out of range
+    }
+    return;
+  }
+
+  const auto structure = s.find(t);
+
+  if (structure == s.end()) {
+    return;
+  }
+
+  const ir::Structure & st = *structure->second;
+  const std::string & name = st.aliases.empty() ? t : st.aliases.front();
+
+  for (const auto & item : v.properties) {
+    for (const auto & property : st.properties) {
+      if (item.first == property.property) {
+        check(item.second, property.type, property.kind, property.width,
+            name + "." + property.property, s);
+        break;
+      }
+    }
+  }
+}
+
+void WidthWriter::check(const ir::Dimension & d, const ir::Key & k,
+    const Structures & s) {
+  for (const auto & item : d.values) {
+    check(item.value, k.type, k.kind, k.width, k.key, s);
+    if (static_cast< bool >(item.dimension)) {
+      check(*item.dimension, k, s);
+    }
+  }
+
+  if (static_cast< bool >(d.next)) {
+    check(*d.next, k, s);
+  }
+}
+
+void WidthWriter::operator () (const Widths & w, ir::Snapshot & s) const {
+  //what a name in the section refers to: the width to set, the type it has
+  typedef std::pair< std::string *, const std::string * > Target;
+  std::map< std::string, Target > targets;
+
+  for (auto & key : s.keys) {
+    targets[key.key] = Target(&key.width, &key.type);
+  }
+
+  for (auto & structure : s.structures) {
+    for (auto & property : structure.properties) {
+      const Target target(&property.width, &property.type);
+      targets[structure.identifier + "." + property.property] = target;
+      for (const auto & alias : structure.aliases) {
+        targets[alias + "." + property.property] = target;
+      }
+    }
+  }
+
+  //explicit widths first, type defaults only fill what is left
+  for (const auto & item : w) {
+    if (item.first == "integer" || item.first == "float") {
+      continue;
+    }
+
+    const auto target = targets.find(item.first);
+
+    if (target == targets.end()) {
+      std::cerr << "width of unknown key or property \"" << item.first
+        << "\"" << std::endl;
+    } else if ( ! valid(*target->second.second, item.second)) {
+      std::cerr << "width \"" << item.second << "\" does not apply to \""
+        << item.first << "\"" << std::endl;
+    } else {
+      *target->second.first = item.second;
+    }
+  }
+
+  for (const auto & item : w) {
+    if (item.first != "integer" && item.first != "float") {
+      continue;
+    }
+
+    if ( ! valid(item.first, item.second)) {
+      std::cerr << "width \"" << item.second << "\" does not apply to \""
+        << item.first << "\"" << std::endl;
+      continue;
+    }
+
+    for (const auto & target : targets) {
+      if (target.second.first->empty() && *target.second.second == item.first) {
+        *target.second.first = item.second;
+      }
+    }
+  }
+
+  Structures structures;
+
+  for (const auto & structure : s.structures) {
+    structures[structure.identifier] = &structure;
+  }
+
+  for (const auto & key : s.keys) {
+    check(key.value, key.type, key.kind, key.width, key.key, structures);
+    if (static_cast< bool >(key.dimension)) {
+      check(*key.dimension, key, structures);
+    }
+  }
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#ifndef WIDTH_WRITER_H
+#define WIDTH_WRITER_H
+
+#include <map>
+#include <string>
+
+#include "ir.h"
+
+/*
+ * sets the width of keys and structure properties out of the "widths"
+ * section: "integer" and "float" change the default of their type,
+ * "Structure.property" names a property (by alias or identifier) and any
+ * other name a key. Integers take int8, int16, int32 or int64, floats take
+ * float or double. Values not fitting the width they end up with are
+ * rejected.
+ */
+struct WidthWriter {
+  typedef std::map< std::string, std::string > Widths;
+  typedef std::map< std::string, const ir::Structure * > Structures;
+
+  void operator () (const Widths &, ir::Snapshot &) const;
+
+  static bool valid(const std::string &, const std::string &);
+  static bool fits(const Value &, const std::string &);
+
+  static void check(const Value &, const std::string &, const ir::Kind,
+      const std::string &, const std::string &, const Structures &);
+  static void check(const ir::Dimension &, const ir::Key &,
+      const Structures &);
+};
+
+#endif
@@ -0,0 +1,16 @@
+(function() {
+  var assert = require('assert');
+
+  function color(d) {
+    return new Configuration(d).color();
+  }
+
+  assert.strictEqual(color({}), 'master');
+  assert.strictEqual(color({'partner': 'x'}), 'master');
+  assert.strictEqual(color({'tier': 'b'}), 'b second');
+  assert.strictEqual(color({'tier': 'b', 'partner': 'x'}), 'b x');
+  assert.strictEqual(color({'tier': 'c'}), 'c');
+  assert.strictEqual(color({'tier': 'c', 'partner': 'x'}), 'c x');
+  assert.strictEqual(color({'tier': 'd'}), 'c or d');
+  assert.strictEqual(color({'tier': 'd', 'partner': 'x'}), 'c or d');
+}());
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "configuration-json.h"
+
+/*
+ * color in tests/limit.yaml has more combinations than the generators look
+ * up by index, every C++ mode has to resolve it by going down the tree.
+ */
+namespace {
+int failures = 0;
+
+void check(std::vector< const char * > c, const char * const e) {
+  char * o = NULL;
+  int s = 0;
+  json(c.data(), c.size(), NULL, 0, &o, &s);
+  if (o == NULL || std::string(o, s) != e) {
+    fprintf(stderr, "expected %s, got %.*s\n", e, s, o != NULL ? o : "");
+    ++failures;
+  }
+  free(o);
+}
+} //end of anonymous namespace
+
+int main(void) {
+  check({}, "{\"color\":\"master\",\"size\":0}");
+  check({"alpha", "unknown"}, "{\"color\":\"master\",\"size\":0}");
+  check({"bravo", "b1"}, "{\"color\":\"master\",\"size\":0}");
+  check({"echo", "e3"}, "{\"color\":\"master\",\"size\":0}");
+  check({"alpha", "a1"}, "{\"color\":\"a\",\"size\":0}");
+  check({"alpha", "a3"}, "{\"color\":\"a\",\"size\":0}");
+  check({"alpha", "a5"}, "{\"color\":\"a\",\"size\":5}");
+  check({"alpha", "a1", "bravo", "b3"}, "{\"color\":\"a1 b\",\"size\":0}");
+  check({"alpha", "a1", "bravo", "b1", "charlie", "c2"},
+      "{\"color\":\"a1 b1 c\",\"size\":0}");
+  check({"alpha", "a1", "bravo", "b1", "charlie", "c1", "delta", "d1"},
+      "{\"color\":\"a1 b1 c1 d\",\"size\":0}");
+  check({"alpha", "a1", "bravo", "b1", "charlie", "c1", "delta", "d1",
+      "echo", "e4"}, "{\"color\":\"a1 b1 c1 d1 e\",\"size\":0}");
+  check({"alpha", "a1", "bravo", "b2", "charlie", "c1", "delta", "d1",
+      "echo", "e1"}, "{\"color\":\"a1 b\",\"size\":0}");
+  check({"alpha", "a1", "bravo", "b1", "charlie", "c1", "echo", "e1"},
+      "{\"color\":\"a1 b1 c\",\"size\":0}");
+  check({"alpha", "a2", "echo", "e3"}, "{\"color\":\"a2 e3\",\"size\":0}");
+  check({"alpha", "a2", "bravo", "b5", "echo", "e3"},
+      "{\"color\":\"a2 e3\",\"size\":0}");
+  check({"alpha", "a2", "echo", "e4"}, "{\"color\":\"a\",\"size\":0}");
+  check({"echo", "e3", "alpha", "a5"}, "{\"color\":\"a\",\"size\":5}");
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015, Yahoo Inc. All rights reserved.
+ * Copyrights licensed under the New BSD License.
+ * See the accompanying LICENSE file for terms.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "configuration-json.h"
+
+/*
+ * prints json() for every combination of the dimension values below, NULL
+ * leaves the dimension out of the context. Every C++ mode has to print the
+ * same as the default switch mode.
+ */
+namespace {
+const char * const TIERS[] = {NULL, "layer7", "unknown"};
+const char * const LANGUAGES[] = {NULL, "en-US", "pt-BR", "en-UK", "unknown"};
+const char * const PROPERTIES[] = {NULL, "frontpage", "search", "unknown"};
+const char * const PARTNERS[] = {NULL, "att", "mozilla", "verizon", "orange",
+  "unknown"};
+
+template < size_t N >
+size_t size(const char * const (&)[N]) {
+  return N;
+}
+
+void print(const char * * v, const int a, const char * * k, const int b) {
+  char * o = NULL;
+  int s = 0;
+  json(v, a, k, b, &o, &s);
+  printf("%.*s\n", s, o);
+  free(o);
+}
+} //end of anonymous namespace
+
+int main(void) {
+  for (size_t i = 0; i < size(TIERS); ++i) {
+    for (size_t j = 0; j < size(LANGUAGES); ++j) {
+      for (size_t k = 0; k < size(PROPERTIES); ++k) {
+        for (size_t l = 0; l < size(PARTNERS); ++l) {
+          const char * v[8];
+          int a = 0;
+
+          if (TIERS[i] != NULL) {
+            v[a++] = "tier";
+            v[a++] = TIERS[i];
+          }
+
+          if (LANGUAGES[j] != NULL) {
+            v[a++] = "language";
+            v[a++] = LANGUAGES[j];
+          }
+
+          if (PROPERTIES[k] != NULL) {
+            v[a++] = "property";
+            v[a++] = PROPERTIES[k];
+          }
+
+          if (PARTNERS[l] != NULL) {
+            v[a++] = "partner";
+            v[a++] = PARTNERS[l];
+          }
+
+          //json() drops the keys it does not know from the list
+          const char * all[] = {"*"};
+          const char * some[] = {"provider", "unknown", "color"};
+
+          print(v, a, all, 1);
+          print(v, a, some, 3);
+          print(v, a, NULL, 0);
+        }
+      }
+    }
+  }
+
+  return 0;
+}